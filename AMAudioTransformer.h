@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include "logging\Logger.h"
 #include "IAudioTransformer.h"
 #include "math\WindowedSincFilter.h"
 
@@ -10,7 +12,35 @@ public:
     AMAudioTransformer();
     ~AMAudioTransformer();
 
+    // Demodulates samples of any type with SampleTraits, storing stereo audio into the destination buffer.
+    template<typename T>
+    void Demodulate(SampleView<T> samples, std::vector<sf::Int16>* destinationBuffer);
+
     // Inherited via IAudioTransformer
-    virtual void Process(std::vector<unsigned char>* samples, std::vector<sf::Int16>* destinationBuffer) override;
+    virtual void Process(SampleView<const IqByte> rawSamples, SampleView<const std::complex<float>> samples, std::vector<sf::Int16>* destinationBuffer) override;
 };
 
+template<typename T>
+void AMAudioTransformer::Demodulate(SampleView<T> samples, std::vector<sf::Int16>* destinationBuffer)
+{
+    // We need to take one point per 54 points to reach approximately 44,100 samples/sec.
+    for (unsigned int i = 0; i < samples.size(); i += 40)
+    {
+        // TODO use filter here.
+
+        // Max range ~= 180.
+        // Amplitude of the I/Q stream as audio samples.
+        float intMax = 32767;
+        float max = 180.0f;
+        float amplifier = 100.0f;
+        float amplitude = amplifier * std::min(max, std::abs(SampleTraits<T>::ToComplexFloat(samples[i])) * 127.5f);
+        // TODO use variables not calculations
+
+
+        // Simulate stereo by passing two samples per sample retrieved.
+        sf::Int64 signal = (sf::Int16)((amplitude / max) * (intMax / max));
+        destinationBuffer->push_back(signal);
+        destinationBuffer->push_back(signal);
+    }
+}
+
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include "logging\Logger.h"
+#include "AsyncLogger.h"
+
+// One thread's queue of messages. The owning thread is the only writer, and the writer thread the only reader.
+struct AsyncLogger::ThreadQueue
+{
+    AsyncLogRecord records[messagesPerThread];
+    std::atomic<unsigned int> writtenRecords;
+    std::atomic<unsigned int> readRecords;
+    std::atomic<unsigned int> droppedRecords;
+
+    ThreadQueue()
+        : writtenRecords(0), readRecords(0), droppedRecords(0)
+    {
+    }
+};
+
+std::mutex AsyncLogger::queuesLock;
+std::vector<std::shared_ptr<AsyncLogger::ThreadQueue>> AsyncLogger::queues;
+
+std::mutex AsyncLogger::drainLock;
+std::atomic<bool> AsyncLogger::running(false);
+std::future<void> AsyncLogger::writerThread;
+
+// Queues are kept after their thread exits, so its last messages are still written.
+static thread_local AsyncLogger::ThreadQueue* threadQueue = nullptr;
+
+void AsyncLogger::AppendBytes(AsyncLogRecord& record, unsigned char tag, const void* value, unsigned int size)
+{
+    if (record.length + 1 + size > AsyncLogRecord::capacity)
+    {
+        record.truncated = true;
+        return;
+    }
+
+    record.data[record.length] = tag;
+    std::memcpy(record.data + record.length + 1, value, size);
+    record.length += 1 + size;
+}
+
+void AsyncLogger::AppendSigned(AsyncLogRecord& record, long long value)
+{
+    AppendBytes(record, 'i', &value, sizeof(value));
+}
+
+void AsyncLogger::AppendUnsigned(AsyncLogRecord& record, unsigned long long value)
+{
+    AppendBytes(record, 'u', &value, sizeof(value));
+}
+
+void AsyncLogger::AppendFloating(AsyncLogRecord& record, double value)
+{
+    AppendBytes(record, 'f', &value, sizeof(value));
+}
+
+void AsyncLogger::Append(AsyncLogRecord& record, char value)
+{
+    AppendBytes(record, 'c', &value, sizeof(value));
+}
+
+void AsyncLogger::Append(AsyncLogRecord& record, const char* value)
+{
+    // Strings are stored as a length byte and the characters, cut short if they don't fit.
+    unsigned int available = AsyncLogRecord::capacity - std::min(record.length + 2, AsyncLogRecord::capacity);
+    unsigned int length = (unsigned int)std::strlen(value);
+    if (record.truncated || available == 0)
+    {
+        record.truncated = true;
+        return;
+    }
+
+    unsigned char storedLength = (unsigned char)std::min(std::min(length, available), 255u);
+    record.data[record.length] = 's';
+    record.data[record.length + 1] = storedLength;
+    std::memcpy(record.data + record.length + 2, value, storedLength);
+    record.length += 2 + storedLength;
+    record.truncated = storedLength != length;
+}
+
+void AsyncLogger::Append(AsyncLogRecord& record, const std::string& value)
+{
+    Append(record, value.c_str());
+}
+
+void AsyncLogger::Submit(const AsyncLogRecord& record)
+{
+    if (!running)
+    {
+        Write(record);
+        return;
+    }
+
+    if (threadQueue == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(queuesLock);
+        queues.push_back(std::make_shared<ThreadQueue>());
+        threadQueue = queues.back().get();
+    }
+
+    unsigned int written = threadQueue->writtenRecords.load(std::memory_order_relaxed);
+    if (written - threadQueue->readRecords.load(std::memory_order_acquire) >= messagesPerThread)
+    {
+        threadQueue->droppedRecords.fetch_add(1);
+    }
+    else
+    {
+        threadQueue->records[written % messagesPerThread] = record;
+        threadQueue->writtenRecords.store(written + 1);
+    }
+
+    // If the logger stopped while this was being queued or dropped, its final drain may have missed it.
+    if (!running)
+    {
+        DrainQueues();
+    }
+}
+
+void AsyncLogger::Write(const AsyncLogRecord& record)
+{
+    std::ostringstream message;
+    for (unsigned int position = 0; position < record.length;)
+    {
+        unsigned char tag = record.data[position++];
+        switch (tag)
+        {
+        case 'i':
+        {
+            long long value;
+            std::memcpy(&value, record.data + position, sizeof(value));
+            message << value;
+            position += sizeof(value);
+            break;
+        }
+        case 'u':
+        {
+            unsigned long long value;
+            std::memcpy(&value, record.data + position, sizeof(value));
+            message << value;
+            position += sizeof(value);
+            break;
+        }
+        case 'f':
+        {
+            double value;
+            std::memcpy(&value, record.data + position, sizeof(value));
+            message << value;
+            position += sizeof(value);
+            break;
+        }
+        case 'c':
+            message << (char)record.data[position];
+            position += 1;
+            break;
+        case 's':
+        {
+            unsigned char length = record.data[position];
+            message.write(reinterpret_cast<const char*>(record.data + position + 1), length);
+            position += 1 + length;
+            break;
+        }
+        default:
+            position = record.length;
+            break;
+        }
+    }
+
+    if (record.truncated)
+    {
+        message << "...";
+    }
+
+    if (record.suppressed != 0)
+    {
+        message << " (" << record.suppressed << " similar messages suppressed)";
+    }
+
+    switch (record.level)
+    {
+    case AsyncLogLevel::Warning:
+        Logger::LogWarn(message.str());
+        break;
+    case AsyncLogLevel::Error:
+        Logger::LogError(message.str());
+        break;
+    default:
+        Logger::Log(message.str());
+        break;
+    }
+}
+
+bool AsyncLogger::DrainQueues()
+{
+    std::lock_guard<std::mutex> drain(drainLock);
+    std::vector<std::shared_ptr<ThreadQueue>> currentQueues;
+    {
+        std::lock_guard<std::mutex> lock(queuesLock);
+        currentQueues = queues;
+    }
+
+    bool wroteAny = false;
+    for (const std::shared_ptr<ThreadQueue>& queue : currentQueues)
+    {
+        unsigned int read = queue->readRecords.load(std::memory_order_relaxed);
+        unsigned int written = queue->writtenRecords.load();
+        for (; read != written; read++)
+        {
+            Write(queue->records[read % messagesPerThread]);
+            queue->readRecords.store(read + 1, std::memory_order_release);
+            wroteAny = true;
+        }
+
+        unsigned int dropped = queue->droppedRecords.exchange(0);
+        if (dropped != 0)
+        {
+            Logger::LogWarn("Dropped ", dropped, " log messages from a thread whose queue was full.");
+            wroteAny = true;
+        }
+    }
+
+    return wroteAny;
+}
+
+void AsyncLogger::WriteMessages()
+{
+    while (running)
+    {
+        if (!DrainQueues())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+void AsyncLogger::Start()
+{
+    if (running)
+    {
+        return;
+    }
+
+    running = true;
+    writerThread = std::async(std::launch::async, &AsyncLogger::WriteMessages);
+}
+
+void AsyncLogger::Stop()
+{
+    running = false;
+    if (writerThread.valid())
+    {
+        writerThread.wait();
+    }
+
+    // Threads that saw the logger running may have queued messages after the writer's last pass.
+    DrainQueues();
+}
+
+LogRateLimiter::LogRateLimiter(float intervalSeconds)
+    : intervalNanoseconds((long long)(intervalSeconds * 1e9f)), nextAllowedNanoseconds(0), suppressed(0)
+{
+}
+
+bool LogRateLimiter::Allow(unsigned int& suppressedSinceLast)
+{
+    long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    long long nextAllowed = nextAllowedNanoseconds.load(std::memory_order_relaxed);
+
+    // If several threads race for the same slot, only one wins it.
+    if (now < nextAllowed || !nextAllowedNanoseconds.compare_exchange_strong(nextAllowed, now + intervalNanoseconds, std::memory_order_relaxed))
+    {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressedSinceLast = suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
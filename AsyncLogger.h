@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+enum class AsyncLogLevel
+{
+    Info,
+    Warning,
+    Error
+};
+
+// A message's arguments, encoded as tagged values so formatting can wait for the writer thread.
+struct AsyncLogRecord
+{
+    static const unsigned int capacity = 240;
+
+    AsyncLogLevel level;
+    unsigned int suppressed;
+    unsigned int length;
+    bool truncated;
+    unsigned char data[capacity];
+};
+
+// Logs from real-time threads without formatting or I/O on them.
+// Arguments are copied into a per-thread queue and formatted and passed to the Logger on a writer thread.
+//  Queuing never blocks: when a thread's queue is full, its messages are dropped and counted instead.
+// Supports the argument types used on the hot paths: numbers, bools, characters and strings. Strings are copied, truncated to fit.
+// Until started (or once stopped), messages are logged directly.
+class AsyncLogger
+{
+public:
+    struct ThreadQueue;
+
+private:
+    static std::mutex queuesLock;
+    static std::vector<std::shared_ptr<ThreadQueue>> queues;
+
+    // Held while reading the queues. Normally only the writer thread does, but Stop and late messages drain them too.
+    static std::mutex drainLock;
+    static std::atomic<bool> running;
+    static std::future<void> writerThread;
+
+    static void Submit(const AsyncLogRecord& record);
+    static bool DrainQueues();
+    static void WriteMessages();
+    static void Write(const AsyncLogRecord& record);
+
+    static void AppendBytes(AsyncLogRecord& record, unsigned char tag, const void* value, unsigned int size);
+    static void AppendSigned(AsyncLogRecord& record, long long value);
+    static void AppendUnsigned(AsyncLogRecord& record, unsigned long long value);
+    static void AppendFloating(AsyncLogRecord& record, double value);
+
+    static void Append(AsyncLogRecord& record, char value);
+    static void Append(AsyncLogRecord& record, const char* value);
+    static void Append(AsyncLogRecord& record, const std::string& value);
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type Append(AsyncLogRecord& record, T value)
+    {
+        AppendSigned(record, (long long)value);
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type Append(AsyncLogRecord& record, T value)
+    {
+        AppendUnsigned(record, (unsigned long long)value);
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type Append(AsyncLogRecord& record, T value)
+    {
+        AppendFloating(record, (double)value);
+    }
+
+public:
+    // Messages each thread can have waiting before further ones are dropped.
+    static const unsigned int messagesPerThread = 256;
+
+    static void Start();
+
+    // Writes any remaining messages, then stops the writer thread.
+    static void Stop();
+
+    // Queues a message, noting how many similar messages were suppressed before it. Use the ASYNC_LOG macros instead.
+    template<typename... Args>
+    static void Enqueue(AsyncLogLevel level, unsigned int suppressed, const Args&... args)
+    {
+        AsyncLogRecord record;
+        record.level = level;
+        record.suppressed = suppressed;
+        record.length = 0;
+        record.truncated = false;
+
+        int expansion[] = { 0, (Append(record, args), 0)... };
+        (void)expansion;
+
+        Submit(record);
+    }
+};
+
+// Lets a call site log at most once per interval, counting the messages it suppresses in between.
+class LogRateLimiter
+{
+    const long long intervalNanoseconds;
+    std::atomic<long long> nextAllowedNanoseconds;
+    std::atomic<unsigned int> suppressed;
+
+public:
+    explicit LogRateLimiter(float intervalSeconds);
+
+    // Returns true if the call site may log now, along with how many messages were suppressed since it last did.
+    bool Allow(unsigned int& suppressedSinceLast);
+};
+
+// Logs through the AsyncLogger, at most once per interval from each call site.
+#define ASYNC_LOG_EVERY(level, intervalSeconds, ...) \
+    do \
+    { \
+        static LogRateLimiter asyncLogRateLimiter(intervalSeconds); \
+        unsigned int asyncLogSuppressed = 0; \
+        if (asyncLogRateLimiter.Allow(asyncLogSuppressed)) \
+        { \
+            AsyncLogger::Enqueue(level, asyncLogSuppressed, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#define ASYNC_LOG(...) ASYNC_LOG_EVERY(AsyncLogLevel::Info, 1.0f, __VA_ARGS__)
+#define ASYNC_LOG_WARN(...) ASYNC_LOG_EVERY(AsyncLogLevel::Warning, 1.0f, __VA_ARGS__)
+#define ASYNC_LOG_ERROR(...) ASYNC_LOG_EVERY(AsyncLogLevel::Error, 1.0f, __VA_ARGS__)
@@ -3,7 +3,7 @@
 
 
 AudioExporter::AudioExporter(SdrBuffer* sdrBuffer)
-    : amAudioTransformer()
+    : amAudioTransformer(), fmAudioTransformer(), demodulatorIndex(0)
 {
     audioStream = new AudioStream(sdrBuffer, &amAudioTransformer);
     audioStream->Start();
@@ -14,3 +14,23 @@ AudioExporter::~AudioExporter()
     audioStream->Stop();
     delete audioStream;
 }
+
+void AudioExporter::CycleDemodulator()
+{
+    demodulatorIndex = (demodulatorIndex + 1) % 3;
+    if (demodulatorIndex == 0)
+    {
+        audioStream->SetAudioTransformer(&amAudioTransformer);
+    }
+    else
+    {
+        fmAudioTransformer.SetPrecision(demodulatorIndex == 1 ? DspPrecision::Float : DspPrecision::FixedPoint);
+        audioStream->SetAudioTransformer(&fmAudioTransformer);
+    }
+}
+
+std::string AudioExporter::GetDemodulatorName() const
+{
+    const char* names[] = { "AM", "FM (float)", "FM (fixed-point)" };
+    return names[demodulatorIndex];
+}
@@ -1,15 +1,25 @@
 #pragma once
 #include "AudioStream.h"
+#include <string>
 #include "AMAudioTransformer.h"
+#include "FMAudioTransformer.h"
 
 // Exports provided sample data as audio by piping it into the current default output audio device.
 class AudioExporter
 {
     AudioStream* audioStream;
     AMAudioTransformer amAudioTransformer;
+    FMAudioTransformer fmAudioTransformer;
+
+    // 0 is AM, 1 is FM in floating-point, 2 is FM in fixed-point.
+    unsigned int demodulatorIndex;
 
 public:
     AudioExporter(SdrBuffer* sdrBuffer);
     virtual ~AudioExporter();
+
+    // Switches to the next demodulator: AM, FM (float), then FM (fixed-point).
+    void CycleDemodulator();
+    std::string GetDemodulatorName() const;
 };
 
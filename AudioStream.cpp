@@ -1,10 +1,15 @@
 #include <limits>
+#include "metrics\MetricsRegistry.h"
+#include "AsyncLogger.h"
 #include "AudioStream.h"
 
 AudioStream::AudioStream(SdrBuffer* sdrBuffer, IAudioTransformer* initialAudioTransformer)
-    : audioOnFirstBuffer(true), audioTransformer(initialAudioTransformer), FilterBase(sdrBuffer)
+    : audioOnFirstBuffer(true), firstBufferCaptureTimes(), secondBufferCaptureTimes(), blockToAudioLatency(), underruns(), playbackThreadNamed(false),
+      audioTransformer(initialAudioTransformer), FilterBase(sdrBuffer)
 {
     initialize(AudioStream::Channels, AudioStream::SampleRate);
+    MetricsRegistry::Register("audio.block_to_audio_latency", &blockToAudioLatency);
+    MetricsRegistry::Register("audio.underruns", &underruns);
 }
 
 void AudioStream::Start()
@@ -22,16 +27,26 @@ void AudioStream::Stop()
 AudioStream::~AudioStream()
 {
     StopFilter();
+    MetricsRegistry::Unregister("audio.block_to_audio_latency", &blockToAudioLatency);
+    MetricsRegistry::Unregister("audio.underruns", &underruns);
 }
 
 bool AudioStream::onGetData(Chunk& data)
 {
+    if (!playbackThreadNamed)
+    {
+        TRACE_THREAD_NAME("Audio playback");
+        playbackThreadNamed = true;
+    }
+
+    TRACE_SCOPE("AudioStream::onGetData");
     audioCopyMutex.lock();
     data.sampleCount = audioOnFirstBuffer ? pingPongFirstBuffer.size() : pingPongSecondBuffer.size();
     data.sampleCount /= AudioStream::Channels;
 
     if (data.sampleCount == 0)
     {
+        underruns.Increment();
         data.sampleCount += 44100 * 2;
         if (audioOnFirstBuffer)
         {
@@ -58,6 +73,16 @@ bool AudioStream::onGetData(Chunk& data)
 
     data.samples = audioOnFirstBuffer ? &pingPongFirstBuffer[0] : &pingPongSecondBuffer[0];
 
+    // The blocks in this buffer reach the device now.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<std::chrono::steady_clock::time_point>& captureTimes = audioOnFirstBuffer ? firstBufferCaptureTimes : secondBufferCaptureTimes;
+    for (const std::chrono::steady_clock::time_point& captureTime : captureTimes)
+    {
+        blockToAudioLatency.Record(now - captureTime);
+    }
+
+    captureTimes.clear();
+
     // Audio will be on the other buffer for the next iteration, so clear it for new samples.
     if (audioOnFirstBuffer)
     {
@@ -69,7 +94,7 @@ bool AudioStream::onGetData(Chunk& data)
     }
 
     audioOnFirstBuffer = !audioOnFirstBuffer; 
-    Logger::Log("Playing from buffer ", audioOnFirstBuffer);
+    ASYNC_LOG("Playing from buffer ", audioOnFirstBuffer);
 
     audioCopyMutex.unlock();
     return true;
@@ -85,15 +110,45 @@ std::string AudioStream::GetName() const
     return "Audio Filter";
 }
 
-void AudioStream::Process(std::vector<unsigned char>* block)
+void AudioStream::OnTuningChanged(const BlockMetadata& metadata)
+{
+    // Audio queued from the previous tuning is no longer relevant, so drop it instead of playing it after the retune.
+    audioCopyMutex.lock();
+    if (audioOnFirstBuffer)
+    {
+        pingPongFirstBuffer.clear();
+        firstBufferCaptureTimes.clear();
+    }
+    else
+    {
+        pingPongSecondBuffer.clear();
+        secondBufferCaptureTimes.clear();
+    }
+
+    audioTransformer->Reset();
+    audioCopyMutex.unlock();
+}
+
+void AudioStream::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
 {
+    TRACE_SCOPE("AudioStream::Process");
     audioCopyMutex.lock();
-    Logger::Log("Processing samples ", block->size(), " ", pingPongFirstBuffer.size(), "-", pingPongSecondBuffer.size(), audioOnFirstBuffer);
+    ASYNC_LOG("Processing samples ", block.size(), " ", pingPongFirstBuffer.size(), "-", pingPongSecondBuffer.size(), audioOnFirstBuffer);
     if (this->getStatus() != sf::SoundSource::Playing)
     {
-        Logger::Log("Restarting play...");
+        ASYNC_LOG("Restarting play...");
         play();
     }
-    audioTransformer->Process(block, audioOnFirstBuffer ? &pingPongFirstBuffer : &pingPongSecondBuffer); // Note that audio is currently playing on the *other* buffer
+    audioTransformer->Process(GetRawSamples(metadata), block, audioOnFirstBuffer ? &pingPongFirstBuffer : &pingPongSecondBuffer); // Note that audio is currently playing on the *other* buffer
+    (audioOnFirstBuffer ? firstBufferCaptureTimes : secondBufferCaptureTimes).push_back(metadata.captureTime);
+    audioCopyMutex.unlock();
+}
+
+void AudioStream::SetAudioTransformer(IAudioTransformer* audioTransformer)
+{
+    // The new transformer may have stale state from when it was last used.
+    audioCopyMutex.lock();
+    audioTransformer->Reset();
+    this->audioTransformer = audioTransformer;
     audioCopyMutex.unlock();
 }
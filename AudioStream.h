@@ -1,8 +1,10 @@
 #pragma once
 #include <SFML\Audio.hpp>
+#include <chrono>
 #include <vector>
 #include <mutex>
 #include "filters\FilterBase.h"
+#include "metrics\Metrics.h"
 #include "sdr\SdrBuffer.h"
 #include "IAudioTransformer.h"
 
@@ -16,6 +18,16 @@ class AudioStream : public sf::SoundStream, public FilterBase
     std::vector<sf::Int16> pingPongFirstBuffer;
     std::vector<sf::Int16> pingPongSecondBuffer;
 
+    // Capture times of the blocks demodulated into each buffer, to measure their latency when the buffer is handed to the device.
+    std::vector<std::chrono::steady_clock::time_point> firstBufferCaptureTimes;
+    std::vector<std::chrono::steady_clock::time_point> secondBufferCaptureTimes;
+
+    LatencyHistogram blockToAudioLatency;
+    Counter underruns;
+
+    // SFML calls onGetData from its own thread, which is named in traces on the first call.
+    bool playbackThreadNamed;
+
     IAudioTransformer* audioTransformer;
 
 public:
@@ -32,7 +44,8 @@ public:
 
     // Inherited via FilterBase
     virtual std::string GetName() const override;
-    virtual void Process(std::vector<unsigned char>* block) override;
+    virtual void OnTuningChanged(const BlockMetadata& metadata) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
 
     void SetAudioTransformer(IAudioTransformer* audioTransformer);
 };
@@ -0,0 +1,90 @@
+#include <vector>
+#include "logging\Logger.h"
+#include "DensityRenderer.h"
+
+DensityRendererProgram DensityRenderer::glslProgram;
+
+bool DensityRenderer::LoadProgram(ShaderFactory* shaderFactory)
+{
+    Logger::Log("Loading the density rendering shading program...");
+    if (!shaderFactory->CreateShaderProgram("density", &glslProgram.programId))
+    {
+        Logger::LogError("Failed to load the density rendering shader; cannot continue.");
+        return false;
+    }
+
+    glslProgram.projMatrixLocation = glGetUniformLocation(glslProgram.programId, "projMatrix");
+    glslProgram.densityTextureLocation = glGetUniformLocation(glslProgram.programId, "densityTexture");
+
+    return true;
+}
+
+DensityRenderer::DensityRenderer(unsigned int columns, unsigned int rows)
+    : columns(columns), rows(rows), lastPosition(0.0f, 0.0f), lastSize(0.0f, 0.0f)
+{
+    // One quad of interleaved positions (xyz) and UVs, drawn as a triangle strip.
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, 4 * 5 * sizeof(GLfloat), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+
+    // Nearest filtering keeps cells crisp, as each is a distinct histogram bin.
+    std::vector<unsigned char> blankCells((std::size_t)columns * rows, 0);
+    glGenTextures(1, &densityTexture);
+    glBindTexture(GL_TEXTURE_2D, densityTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, columns, rows, 0, GL_RED, GL_UNSIGNED_BYTE, blankCells.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void DensityRenderer::SetDensity(const unsigned char* levels)
+{
+    glBindTexture(GL_TEXTURE_2D, densityTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, levels);
+}
+
+void DensityRenderer::Render(glm::mat4& projectionMatrix, glm::vec2 position, glm::vec2 size)
+{
+    glUseProgram(glslProgram.programId);
+    glBindVertexArray(vao);
+
+    if (position != lastPosition || size != lastSize)
+    {
+        const GLfloat vertices[] =
+        {
+            position.x, position.y, 0.0f, 0.0f, 0.0f,
+            position.x + size.x, position.y, 0.0f, 1.0f, 0.0f,
+            position.x, position.y + size.y, 0.0f, 0.0f, 1.0f,
+            position.x + size.x, position.y + size.y, 0.0f, 1.0f, 1.0f
+        };
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+        lastPosition = position;
+        lastSize = size;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, densityTexture);
+    glUniform1i(glslProgram.densityTextureLocation, 0);
+    glUniformMatrix4fv(glslProgram.projMatrixLocation, 1, GL_FALSE, &projectionMatrix[0][0]);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+DensityRenderer::~DensityRenderer()
+{
+    glDeleteTextures(1, &densityTexture);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
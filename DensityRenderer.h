@@ -0,0 +1,44 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm\vec2.hpp>
+#include <glm\mat4x4.hpp>
+#include "GuCommon\shaders\ShaderFactory.h"
+
+struct DensityRendererProgram
+{
+    GLuint programId;
+
+    GLuint projMatrixLocation;
+    GLuint densityTextureLocation;
+};
+
+// Renders a 2D histogram from a texture of cell densities, colormapped in the fragment shader.
+// The whole histogram is one upload and one quad, however many samples went into it.
+class DensityRenderer
+{
+    static DensityRendererProgram glslProgram;
+
+    GLuint vao;
+    GLuint vertexBuffer;
+    GLuint densityTexture;
+
+    unsigned int columns;
+    unsigned int rows;
+
+    // The quad is only re-uploaded when the pane moves or resizes.
+    glm::vec2 lastPosition;
+    glm::vec2 lastSize;
+
+public:
+    static bool LoadProgram(ShaderFactory* shaderFactory);
+
+    DensityRenderer(unsigned int columns, unsigned int rows);
+
+    // Uploads columns x rows levels, row by row from the bottom, from 0 (bottom of the colormap) to 255 (top).
+    void SetDensity(const unsigned char* levels);
+
+    // Renders into the provided position and size.
+    void Render(glm::mat4& projectionMatrix, glm::vec2 position, glm::vec2 size);
+
+    ~DensityRenderer();
+};
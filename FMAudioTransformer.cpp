@@ -1,17 +1,135 @@
+#include <cmath>
+#include "math\Constants.h"
 #include "FMAudioTransformer.h"
 
+FMAudioTransformer::FMAudioTransformer()
+    : precision(DspPrecision::Float), activePrecision(DspPrecision::Float), basebandFilter(), audioPhase(0),
+      floatInput(), floatBaseband(), lastFloatSample(1.0f, 0.0f), floatDeemphasis(0.0f), floatAudioSum(0.0f),
+      iqConverter(), fixedPointInput(), fixedPointBaseband(), fixedPointDeemphasis(0), fixedPointAudioSum(0)
+{
+    basebandFilter.CreateFilter(basebandCutoff, basebandKernelLength);
 
+    // Single-pole low-pass with the de-emphasis time constant.
+    deemphasisRate = 1.0f - std::exp(-1.0f / (basebandSampleRate * deemphasisTimeConstant));
+    fixedPointDeemphasisRate = FixedPoint::ToQ15(deemphasisRate);
+    fixedPointAudioScale = FixedPoint::ToQ15(audioGain / (float)audioDecimation);
 
-FMAudioTransformer::FMAudioTransformer()
+    lastFixedPointSample.i = 32767;
+    lastFixedPointSample.q = 0;
+}
+
+FMAudioTransformer::~FMAudioTransformer()
 {
 }
 
+void FMAudioTransformer::SetPrecision(DspPrecision precision)
+{
+    this->precision = precision;
+}
 
-FMAudioTransformer::~FMAudioTransformer()
+DspPrecision FMAudioTransformer::GetPrecision() const
 {
+    return precision;
 }
 
-void FMAudioTransformer::Process(std::vector<unsigned char>* samples, std::vector<sf::Int16>* destinationBuffer)
+void FMAudioTransformer::Reset()
 {
-    // TODO figure out the best way to deserialize FM stereo audio.
+    audioPhase = 0;
+
+    floatInput.Clear();
+    lastFloatSample = std::complex<float>(1.0f, 0.0f);
+    floatDeemphasis = 0.0f;
+    floatAudioSum = 0.0f;
+
+    iqConverter.ResetDcOffset();
+    fixedPointInput.Clear();
+    lastFixedPointSample.i = 32767;
+    lastFixedPointSample.q = 0;
+    fixedPointDeemphasis = 0;
+    fixedPointAudioSum = 0;
+}
+
+void FMAudioTransformer::Process(SampleView<const IqByte> rawSamples, SampleView<const std::complex<float>> samples, std::vector<sf::Int16>* destinationBuffer)
+{
+    // Each path only tracks its own state, so switching paths starts afresh.
+    DspPrecision currentPrecision = precision;
+    if (currentPrecision != activePrecision)
+    {
+        Reset();
+        activePrecision = currentPrecision;
+    }
+
+    if (activePrecision == DspPrecision::FixedPoint)
+    {
+        DemodulateFixedPoint(rawSamples, destinationBuffer);
+    }
+    else
+    {
+        DemodulateFloat(samples, destinationBuffer);
+    }
+}
+
+void FMAudioTransformer::DemodulateFloat(SampleView<const std::complex<float>> samples, std::vector<sf::Int16>* destinationBuffer)
+{
+    std::size_t historyLength = floatInput.size();
+    floatInput.Resize(historyLength + samples.size());
+    std::copy(samples.begin(), samples.end(), floatInput.data() + historyLength);
+
+    basebandFilter.Decimate(floatInput.View(), basebandDecimation, floatBaseband);
+    DiscardConsumed(floatInput, floatBaseband.size() * basebandDecimation);
+
+    float audioScale = audioGain / (float)audioDecimation;
+    for (std::size_t i = 0; i < floatBaseband.size(); i++)
+    {
+        // The phase change between consecutive samples is proportional to the instantaneous frequency.
+        std::complex<float> sample = floatBaseband[i];
+        float phaseChange = std::arg(sample * std::conj(lastFloatSample)) / Constants::PI;
+        lastFloatSample = sample;
+
+        floatDeemphasis += deemphasisRate * (phaseChange - floatDeemphasis);
+        floatAudioSum += floatDeemphasis;
+        if (++audioPhase == audioDecimation)
+        {
+            // Simulate stereo by passing two samples per sample retrieved.
+            sf::Int16 signal = FixedPoint::Saturate((int)std::lround(floatAudioSum * audioScale * 32768.0f));
+            destinationBuffer->push_back(signal);
+            destinationBuffer->push_back(signal);
+
+            floatAudioSum = 0.0f;
+            audioPhase = 0;
+        }
+    }
+}
+
+void FMAudioTransformer::DemodulateFixedPoint(SampleView<const IqByte> rawSamples, std::vector<sf::Int16>* destinationBuffer)
+{
+    std::size_t historyLength = fixedPointInput.size();
+    fixedPointInput.Resize(historyLength + rawSamples.size());
+    iqConverter.ConvertToInt16(rawSamples, fixedPointInput.Subview(historyLength, rawSamples.size()));
+
+    basebandFilter.DecimateFixedPoint(fixedPointInput.View(), basebandDecimation, fixedPointBaseband);
+    DiscardConsumed(fixedPointInput, fixedPointBaseband.size() * basebandDecimation);
+
+    for (std::size_t i = 0; i < fixedPointBaseband.size(); i++)
+    {
+        // sample * conj(lastSample), with each product halved so their sum can't overflow.
+        ComplexInt16 sample = fixedPointBaseband[i];
+        int real = (((int)sample.i * lastFixedPointSample.i) >> 1) + (((int)sample.q * lastFixedPointSample.q) >> 1);
+        int imag = (((int)sample.q * lastFixedPointSample.i) >> 1) - (((int)sample.i * lastFixedPointSample.q) >> 1);
+        int phaseChange = FixedPoint::Atan2(imag, real);
+        lastFixedPointSample = sample;
+
+        // The de-emphasis state keeps 8 extra fractional bits, so small steps aren't truncated away.
+        fixedPointDeemphasis += (int)(((long long)fixedPointDeemphasisRate * ((phaseChange << 8) - fixedPointDeemphasis)) >> 15);
+        fixedPointAudioSum += fixedPointDeemphasis >> 8;
+        if (++audioPhase == audioDecimation)
+        {
+            sf::Int16 signal = FixedPoint::Saturate((int)(((long long)fixedPointAudioSum * fixedPointAudioScale + (1 << 14)) >> 15));
+            destinationBuffer->push_back(signal);
+            destinationBuffer->push_back(signal);
+
+            fixedPointAudioSum = 0;
+            audioPhase = 0;
+        }
+    }
 }
@@ -1,13 +1,77 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include "math\FixedPoint.h"
+#include "math\IqConverter.h"
+#include "math\WindowedSincFilter.h"
 #include "IAudioTransformer.h"
 
+// Demodulates wideband FM into audio, in either floating-point or Q15 fixed-point.
+// 2.4 MS/s is filtered down to 400 kS/s, passed through a phase discriminator and de-emphasis, then averaged down to ~44.4 kS/s.
 class FMAudioTransformer : public IAudioTransformer
 {
+    const unsigned int basebandDecimation = 6;
+    const unsigned int audioDecimation = 9;
+    const float basebandSampleRate = 400000.0f;
+
+    // Passes the +-100 kHz broadcast channel, as a fraction of the 2.4 MS/s input rate.
+    const float basebandCutoff = 100000.0f / 2400000.0f;
+    const int basebandKernelLength = 48;
+
+    // US broadcast de-emphasis time constant, in seconds.
+    const float deemphasisTimeConstant = 75e-6f;
+
+    // Full deviation (75 kHz) is 0.375 PI radians per baseband sample, so this brings it close to full scale.
+    const float audioGain = 2.0f;
+
+    std::atomic<DspPrecision> precision;
+    DspPrecision activePrecision;
+
+    WindowedSincFilter basebandFilter;
+    float deemphasisRate;
+    short fixedPointDeemphasisRate;
+    short fixedPointAudioScale;
+    unsigned int audioPhase;
+
+    // Floating-point state. The input keeps samples the filter hasn't consumed yet, so it runs continuously across blocks.
+    SampleBlock<std::complex<float>> floatInput;
+    SampleBlock<std::complex<float>> floatBaseband;
+    std::complex<float> lastFloatSample;
+    float floatDeemphasis;
+    float floatAudioSum;
+
+    // Fixed-point state, converting from the raw bytes itself so floats are never used.
+    IqConverter iqConverter;
+    SampleBlock<ComplexInt16> fixedPointInput;
+    SampleBlock<ComplexInt16> fixedPointBaseband;
+    ComplexInt16 lastFixedPointSample;
+    int fixedPointDeemphasis;
+    int fixedPointAudioSum;
+
+    // Removes samples the filter has consumed from the front of the input.
+    template<typename T>
+    static void DiscardConsumed(SampleBlock<T>& input, std::size_t consumed);
+
+    void DemodulateFloat(SampleView<const std::complex<float>> samples, std::vector<sf::Int16>* destinationBuffer);
+    void DemodulateFixedPoint(SampleView<const IqByte> rawSamples, std::vector<sf::Int16>* destinationBuffer);
+
 public:
     FMAudioTransformer();
     ~FMAudioTransformer();
 
+    // Switches between the floating-point and fixed-point paths. Takes effect on the next block.
+    void SetPrecision(DspPrecision precision);
+    DspPrecision GetPrecision() const;
+
     // Inherited via IAudioTransformer
-    virtual void Process(std::vector<unsigned char>* samples, std::vector<sf::Int16>* destinationBuffer) override;
+    virtual void Process(SampleView<const IqByte> rawSamples, SampleView<const std::complex<float>> samples, std::vector<sf::Int16>* destinationBuffer) override;
+    virtual void Reset() override;
 };
 
+template<typename T>
+void FMAudioTransformer::DiscardConsumed(SampleBlock<T>& input, std::size_t consumed)
+{
+    std::size_t remaining = input.size() - std::min(consumed, input.size());
+    std::copy(input.data() + (input.size() - remaining), input.data() + input.size(), input.data());
+    input.Resize(remaining);
+}
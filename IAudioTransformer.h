@@ -1,11 +1,18 @@
 #pragma once
 #include <vector>
 #include <SFML\Audio.hpp>
+#include "math\SampleBlock.h"
 
 // Transforms raw samples into audio samples.
 class IAudioTransformer
 {
 public:
     // Processes a block of samples, storing them into a destination buffer.
-    virtual void Process(std::vector<unsigned char>* samples, std::vector<sf::Int16>* destinationBuffer) = 0;
+    // Both views hold the same block; the raw bytes are for transformers that avoid floating-point.
+    virtual void Process(SampleView<const IqByte> rawSamples, SampleView<const std::complex<float>> samples, std::vector<sf::Int16>* destinationBuffer) = 0;
+
+    // Discards state carried between blocks, for when the input is no longer continuous.
+    virtual void Reset()
+    {
+    }
 };
@@ -17,5 +17,17 @@ public:
 
     // Renders into the provided position and size on the XY plane.
     virtual void Render(glm::mat4& projectionMatrix, glm::vec2 position, glm::vec2 size) = 0;
+
+    // Called when the pane is zoomed or resized, with the visible horizontal range as fractions of the full range [0, 1],
+    //  and the pane's width in pixels. Contents that compute their own data can limit it to what will be displayed.
+    virtual void SetVisibleRange(float start, float stop, int pixelWidth)
+    {
+    }
+
+    // Called when the pane is collapsed or moves off-screen, and again when it can be seen. Contents computed from
+    //  incoming data should stop computing what won't be shown.
+    virtual void SetVisible(bool visible)
+    {
+    }
 };
 
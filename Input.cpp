@@ -12,6 +12,8 @@ std::set<int> Input::pressedKeysTypeChecked;
 std::set<int> Input::pressedMouseButtons;
 std::set<int> Input::pressedMouseButtonsTypeChecked;
 
+float Input::scrollOffset = 0.0f;
+
 void Input::SetupErrorCallback()
 {
     glfwSetErrorCallback(Input::LogGlfwErrors);
@@ -30,6 +32,7 @@ void Input::Setup(GLFWwindow* window, Viewer* viewer)
     glfwSetWindowFocusCallback(window, Input::GlfwWindowFocusCallbacks);
     glfwSetWindowSizeCallback(window, Input::GlfwWindowResizeCallbacks);
     glfwSetMouseButtonCallback(window, Input::GlfwMouseButtonCallbacks);
+    glfwSetScrollCallback(window, Input::GlfwScrollCallbacks);
 }
 
 // Logs any errors from GLFW
@@ -72,6 +75,11 @@ void Input::GlfwMouseButtonCallbacks(GLFWwindow* window, int button, int action,
     }
 }
 
+void Input::GlfwScrollCallbacks(GLFWwindow* window, double xOffset, double yOffset)
+{
+    scrollOffset += (float)yOffset;
+}
+
 void Input::GlfwWindowCloseCallbacks(GLFWwindow* window)
 {
     glfwSetWindowShouldClose(window, GLFW_TRUE);
@@ -150,4 +158,14 @@ glm::ivec2 Input::GetMousePos()
     double xPos, yPos;
     glfwGetCursorPos(window, &xPos, &yPos);
     return glm::ivec2((int)xPos, (int)yPos);
-}
\ No newline at end of file
+}
+
+float Input::GetScrollOffset()
+{
+    return scrollOffset;
+}
+
+void Input::ClearScrollOffset()
+{
+    scrollOffset = 0.0f;
+}
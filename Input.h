@@ -24,6 +24,9 @@ class Input
     static std::set<int> pressedMouseButtons;
     static std::set<int> pressedMouseButtonsTypeChecked;
 
+    // Vertical scrolling since the last event poll.
+    static float scrollOffset;
+
     // Logs any errors from GLFW
     static void LogGlfwErrors(int error, const char* description);
 
@@ -33,6 +36,9 @@ class Input
     // Handles GLFW mouse button callbacks.
     static void GlfwMouseButtonCallbacks(GLFWwindow* window, int button, int action, int mods);
 
+    // Handles GLFW mouse scroll callbacks.
+    static void GlfwScrollCallbacks(GLFWwindow* window, double xOffset, double yOffset);
+
     // Handles GLFW window close callbacks.
     static void GlfwWindowCloseCallbacks(GLFWwindow* window);
 
@@ -61,5 +67,11 @@ public:
     static bool IsMouseButtonClicked(int mouseButton);
 
     static glm::ivec2 GetMousePos();
+
+    // Returns how far the mouse wheel was scrolled this frame, with positive values scrolling up.
+    static float GetScrollOffset();
+
+    // Resets the scroll offset. Called before polling for the next frame's events.
+    static void ClearScrollOffset();
 };
 
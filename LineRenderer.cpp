@@ -16,48 +16,171 @@ bool LineRenderer::LoadProgram(ShaderFactory* shaderFactory)
     glslProgram.pointSizeLocation = glGetUniformLocation(glslProgram.programId, "pointSize");
     glslProgram.transparencyLocation = glGetUniformLocation(glslProgram.programId, "transparency");
 
+    Logger::Log("Loading the series rendering shading program for line rendering...");
+    if (!shaderFactory->CreateShaderProgram("seriesRender", &glslProgram.seriesProgramId))
+    {
+        Logger::LogError("Failed to load the series rendering shader; cannot continue.");
+        return false;
+    }
+
+    glslProgram.seriesProjMatrixLocation = glGetUniformLocation(glslProgram.seriesProgramId, "projMatrix");
+    glslProgram.seriesPointSizeLocation = glGetUniformLocation(glslProgram.seriesProgramId, "pointSize");
+    glslProgram.seriesColorLocation = glGetUniformLocation(glslProgram.seriesProgramId, "seriesColor");
+    glslProgram.implicitXLocation = glGetUniformLocation(glslProgram.seriesProgramId, "implicitX");
+
     return true;
 }
 
-LineRenderer::LineRenderer(bool isLineStrip)
-    : isLineStrip(isLineStrip)
+LineRenderer::LineRenderer(bool isLineStrip, std::size_t streamingCapacity, PlotVertexFormat format)
+    : streamingCapacity(streamingCapacity), format(format), positionStream(), colorStream(), pointStream(), valueStream(),
+      seriesColor(1.0f, 1.0f, 1.0f), xOrigin(0.0f), xStep(0.0f), isLineStrip(isLineStrip), points(), values()
 {
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
-    positionBuffer.Initialize();
-    colorBuffer.Initialize();
+    if (format != PlotVertexFormat::PositionColor && streamingCapacity == 0)
+    {
+        Logger::LogError("Compact line formats need a streaming capacity; nothing will be drawn.");
+    }
+
+    // The vertex vectors become the staging area. Reserving up front means they never grow while streaming.
+    switch (format)
+    {
+    case PlotVertexFormat::Position2d:
+        pointStream.Initialize(0, 2, streamingCapacity);
+        points.reserve(streamingCapacity);
+        break;
+    case PlotVertexFormat::ImplicitX:
+        valueStream.Initialize(0, 1, streamingCapacity);
+        values.reserve(streamingCapacity);
+        break;
+    default:
+        if (streamingCapacity != 0)
+        {
+            positionStream.Initialize(0, 3, streamingCapacity);
+            colorStream.Initialize(1, 3, streamingCapacity);
+            positionBuffer.vertices.reserve(streamingCapacity);
+            colorBuffer.vertices.reserve(streamingCapacity);
+        }
+        else
+        {
+            positionBuffer.Initialize();
+            colorBuffer.Initialize();
+        }
+        break;
+    }
+
     lastBufferSize = 0;
 }
 
+void LineRenderer::SetSeriesColor(glm::vec3 color)
+{
+    seriesColor = color;
+}
+
+void LineRenderer::SetImplicitX(float origin, float step)
+{
+    xOrigin = origin;
+    xStep = step;
+}
+
+void LineRenderer::UploadCompact(const std::vector<glm::vec2>& points, const std::vector<float>& values)
+{
+    glBindVertexArray(vao);
+    if (format == PlotVertexFormat::Position2d)
+    {
+        pointStream.Upload(points.data(), points.size());
+        lastBufferSize = pointStream.GetVertexCount();
+    }
+    else if (format == PlotVertexFormat::ImplicitX)
+    {
+        valueStream.Upload(values.data(), values.size());
+        lastBufferSize = valueStream.GetVertexCount();
+    }
+}
+
+void LineRenderer::Update(const SeriesSnapshot& snapshot)
+{
+    xOrigin = snapshot.xOrigin;
+    xStep = snapshot.xStep;
+    UploadCompact(snapshot.points, snapshot.values);
+}
+
 void LineRenderer::Update()
 {
     glBindVertexArray(vao);
-    positionBuffer.TransferToOpenGl();
-    colorBuffer.TransferToOpenGl();
-    lastBufferSize = positionBuffer.vertices.size();
+    switch (format)
+    {
+    case PlotVertexFormat::Position2d:
+    case PlotVertexFormat::ImplicitX:
+        UploadCompact(points, values);
+        break;
+    default:
+        if (streamingCapacity != 0)
+        {
+            positionStream.Upload(positionBuffer.vertices.data(), positionBuffer.vertices.size());
+            colorStream.Upload(colorBuffer.vertices.data(), colorBuffer.vertices.size());
+            lastBufferSize = positionStream.GetVertexCount();
+        }
+        else
+        {
+            positionBuffer.TransferToOpenGl();
+            colorBuffer.TransferToOpenGl();
+            lastBufferSize = positionBuffer.vertices.size();
+        }
+        break;
+    }
 }
 
 
 void LineRenderer::Render(glm::mat4& projectionMatrix)
 {
+    if (format != PlotVertexFormat::PositionColor)
+    {
+        GLint firstVertex = format == PlotVertexFormat::Position2d ? pointStream.GetFirstVertex() : valueStream.GetFirstVertex();
+        float implicitStep = format == PlotVertexFormat::ImplicitX ? xStep : 0.0f;
+
+        glUseProgram(glslProgram.seriesProgramId);
+        glBindVertexArray(vao);
+        glUniformMatrix4fv(glslProgram.seriesProjMatrixLocation, 1, GL_FALSE, &projectionMatrix[0][0]);
+        glUniform1f(glslProgram.seriesPointSizeLocation, 1.0f);
+        glUniform3f(glslProgram.seriesColorLocation, seriesColor.x, seriesColor.y, seriesColor.z);
+        glUniform3f(glslProgram.implicitXLocation, xOrigin, implicitStep, (float)firstVertex);
+
+        glDrawArrays(isLineStrip ? GL_LINE_STRIP : GL_LINES, firstVertex, lastBufferSize);
+        pointStream.Fence();
+        valueStream.Fence();
+        return;
+    }
+
     glUseProgram(glslProgram.programId);
     glBindVertexArray(vao);
     glUniformMatrix4fv(glslProgram.projMatrixLocation, 1, GL_FALSE, &projectionMatrix[0][0]);
-    
+
     // TODO should be configurable.
     glUniform1f(glslProgram.transparencyLocation, 1.0f);
     
     // TODO use a dedicated shader so I don't need this.
     // glUniform1f(spectrumProgram.pointSizeLocation, 1.0f);
 
-    glDrawArrays(isLineStrip ? GL_LINE_STRIP : GL_LINES, 0, lastBufferSize);
+    if (streamingCapacity != 0)
+    {
+        glDrawArrays(isLineStrip ? GL_LINE_STRIP : GL_LINES, positionStream.GetFirstVertex(), lastBufferSize);
+        positionStream.Fence();
+        colorStream.Fence();
+    }
+    else
+    {
+        glDrawArrays(isLineStrip ? GL_LINE_STRIP : GL_LINES, 0, lastBufferSize);
+    }
 }
 
 void LineRenderer::Clear()
 {
     positionBuffer.vertices.clear();
     colorBuffer.vertices.clear();
+    points.clear();
+    values.clear();
 }
 
 void LineRenderer::AddXYRectangle(glm::vec3 lowerRightPos, glm::vec2 size, glm::vec3 color)
@@ -83,6 +206,25 @@ void LineRenderer::AddXYRectangle(glm::vec3 lowerRightPos, glm::vec2 size, glm::
 LineRenderer::~LineRenderer()
 {
     glDeleteVertexArrays(1, &vao);
-    positionBuffer.Deinitialize();
-    colorBuffer.Deinitialize();
+    switch (format)
+    {
+    case PlotVertexFormat::Position2d:
+        pointStream.Deinitialize();
+        break;
+    case PlotVertexFormat::ImplicitX:
+        valueStream.Deinitialize();
+        break;
+    default:
+        if (streamingCapacity != 0)
+        {
+            positionStream.Deinitialize();
+            colorStream.Deinitialize();
+        }
+        else
+        {
+            positionBuffer.Deinitialize();
+            colorBuffer.Deinitialize();
+        }
+        break;
+    }
 }
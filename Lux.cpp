@@ -5,9 +5,14 @@
 #include "logging\Logger.h"
 #include "filters\IQSpectrum.h"
 #include "filters\FrequencySpectrum.h"
+#include "metrics\MetricsRegistry.h"
+#include "metrics\Tracer.h"
+#include "DensityRenderer.h"
 #include "Input.h"
 #include "LineRenderer.h"
 #include "PointRenderer.h"
+#include "WaterfallRenderer.h"
+#include "AsyncLogger.h"
 #include "version.h"
 #include "Lux.h"
 
@@ -20,7 +25,8 @@
 Lux::Lux() 
     : shaderFactory(), sentenceManager(), viewer(),
       sdr(), dataBuffer(&sdr, 0, 30), // TODO config somewhere, with device ID passed in somewhere else
-      fpsTimeAggregated(0.0f), fpsFramesCounted(0)
+      sweepScanner(&sdr, 0), preSweepFrequency(0), occupancyStore(),
+      detectionSummary(), fpsTimeAggregated(0.0f), fpsFramesCounted(0)
 {
 }
 
@@ -114,6 +120,18 @@ bool Lux::LoadCoreGlslGraphics()
         return false;
     }
 
+    if (!WaterfallRenderer::LoadProgram(&shaderFactory))
+    {
+        Logger::LogError("Could not load the waterfall rendering program!");
+        return false;
+    }
+
+    if (!DensityRenderer::LoadProgram(&shaderFactory))
+    {
+        Logger::LogError("Could not load the density rendering program!");
+        return false;
+    }
+
     return true;
 }
 
@@ -135,6 +153,12 @@ bool Lux::Initialize()
     Logger::Log("Setting gain of tuner: ", sdr.SetTunerGain(0, 0));
     dataBuffer.StartAcquisition();
 
+    // Sweep the entire tuner range, discarding 2 blocks (~7 ms) after each retune and averaging 32 FFTs per dwell.
+    Logger::Log("Configuring the sweep scanner: ", sweepScanner.Configure(Sdr::ValidFrequencyRanges[0].x, Sdr::ValidFrequencyRanges[0].y, 1024, 2, 4));
+
+    Logger::Log("Opening the occupancy store: ", occupancyStore.Open("lux-occupancy.bin", 1024));
+    MetricsRegistry::StartPeriodicDump("lux-metrics.json", 5.0f);
+
     // Setup GLFW
     if (!glfwInit())
     {
@@ -147,12 +171,16 @@ bool Lux::Initialize()
 
 void Lux::Deinitialize()
 {
+    sweepScanner.StopSweep();
     dataBuffer.StopAcquisition();
+    occupancyStore.Close();
+    MetricsRegistry::StopPeriodicDump();
     glfwTerminate();
 }
 
 void Lux::HandleEvents(bool& focusPaused, bool& escapePaused)
 {
+    Input::ClearScrollOffset();
     glfwPollEvents();
     focusPaused = !Input::hasFocus;
     escapePaused = Input::IsKeyTyped(GLFW_KEY_ESCAPE);
@@ -173,6 +201,49 @@ void Lux::UpdateFps(float frameTime)
     }
 }
 
+// Switches the device between continuous acquisition at one frequency and sweeping across the whole tuner range.
+void Lux::ToggleSweep()
+{
+    if (sweepScanner.IsSweeping())
+    {
+        sweepScanner.StopSweep();
+
+        // Sweeping leaves the device at an arbitrary frequency, so restore the one we were acquiring at.
+        Logger::Log("Restoring center frequency: ", sdr.SetCenterFrequency(0, preSweepFrequency));
+        dataBuffer.StartAcquisition();
+    }
+    else
+    {
+        preSweepFrequency = sdr.GetCenterFrequency(0);
+        dataBuffer.StopAcquisition();
+        dataBuffer.WaitForAcquisitionStop();
+        sweepScanner.StartSweep();
+    }
+}
+
+void Lux::UpdateDetections()
+{
+    SignalDetection detection;
+    SignalDetection strongest;
+    unsigned int detectionCount = 0;
+    while (fourierFilter->GetDetector().PopDetection(detection))
+    {
+        if (detectionCount == 0 || detection.snrDb > strongest.snrDb)
+        {
+            strongest = detection;
+        }
+
+        ++detectionCount;
+    }
+
+    if (detectionCount != 0)
+    {
+        std::stringstream summary;
+        summary << ", Signal: " << strongest.frequency / 1e6 << " MHz (" << strongest.snrDb << " dB SNR, " << strongest.bandwidth / 1e3 << " kHz)";
+        detectionSummary = summary.str();
+    }
+}
+
 // TODO hacky code to remove with a redesign. Still prototyping here...
 int gainId = 0;
 void Lux::Update(float currentTime, float frameTime)
@@ -185,7 +256,16 @@ void Lux::Update(float currentTime, float frameTime)
     sentenceManager.UpdateSentence(mouseToolTipSentenceId, mousePos.str());
 
     std::stringstream speed;
-    speed << "Rate: " << dataBuffer.GetCurrentSampleRate();
+    if (sweepScanner.IsSweeping())
+    {
+        speed << "Sweep: " << sweepScanner.GetSweepRate() << " MHz/s";
+    }
+    else
+    {
+        UpdateDetections();
+        speed << "Rate: " << dataBuffer.GetCurrentSampleRate() << detectionSummary;
+    }
+
     sentenceManager.UpdateSentence(dataSpeedSentenceId, speed.str());
 
     UpdateFps(frameTime);
@@ -194,19 +274,45 @@ void Lux::Update(float currentTime, float frameTime)
     {
         ++gainId;
         gainId = std::min((int)sdr.GetTunerGainSettings(0).size() - 1, gainId);
-        Logger::Log("Setting gain of tuner to ID ", gainId, ": ", sdr.SetTunerGain(0, gainId));
+        Logger::Log("Setting gain of tuner to ID ", gainId, ": ", dataBuffer.SetTunerGain(gainId));
     }
     else if (Input::IsKeyTyped(GLFW_KEY_DOWN))
     {
         --gainId;
         gainId = std::max(gainId, 0);
-        Logger::Log("Setting gain of tuner to ID ", gainId, ": ", sdr.SetTunerGain(0, gainId));
+        Logger::Log("Setting gain of tuner to ID ", gainId, ": ", dataBuffer.SetTunerGain(gainId));
+    }
+
+    if (Input::IsKeyTyped(GLFW_KEY_S))
+    {
+        ToggleSweep();
+    }
+
+    if (Input::IsKeyTyped(GLFW_KEY_M))
+    {
+        audioExporter->CycleDemodulator();
+        Logger::Log("Demodulating audio as ", audioExporter->GetDemodulatorName());
+    }
+
+    if (Input::IsKeyTyped(GLFW_KEY_I))
+    {
+        bool showDensity = iqSpectrum->GetDisplayMode() != IqDisplayMode::Density;
+        iqSpectrum->SetDisplayMode(showDensity ? IqDisplayMode::Density : IqDisplayMode::Points);
+        Logger::Log("Showing IQ samples as ", showDensity ? "a density heatmap" : "points");
+    }
+
+    // Dumps the recent activity of every thread, such as after hearing a glitch.
+    if (Input::IsKeyTyped(GLFW_KEY_T))
+    {
+        Tracer::WriteChromeTrace("lux-trace.json");
     }
 
     // Update our panes.
     fourierTransformPane->Update(currentTime, frameTime);
     iqSpectrumPane->Update(currentTime, frameTime);
     spectrumPane->Update(currentTime, frameTime);
+    sweepSpectrumPane->Update(currentTime, frameTime);
+    waterfallPane->Update(currentTime, frameTime);
 }
 
 void Lux::Render(glm::mat4& viewMatrix)
@@ -240,6 +346,8 @@ void Lux::Render(glm::mat4& viewMatrix)
     fourierTransformPane->Render(projectionMatrix, viewer.perspectiveMatrix, viewMatrix);
     iqSpectrumPane->Render(projectionMatrix, viewer.perspectiveMatrix, viewMatrix);
     spectrumPane->Render(projectionMatrix, viewer.perspectiveMatrix, viewMatrix);
+    sweepSpectrumPane->Render(projectionMatrix, viewer.perspectiveMatrix, viewMatrix);
+    waterfallPane->Render(projectionMatrix, viewer.perspectiveMatrix, viewMatrix);
 }
 
 bool Lux::LoadGraphics()
@@ -263,6 +371,7 @@ bool Lux::LoadGraphics()
     glm::vec2 paneSize = glm::vec2(30.0f, 30.0f);
     fourierFilter = new FrequencySpectrum(panePos, paneSize, &dataBuffer);
     fourierTransformPane = new Pane(panePos, paneSize, &viewer, &sentenceManager, fourierFilter);
+    fourierFilter->SetOccupancyStore(&occupancyStore);
 
     panePos = glm::vec2(-29.0f, -30.0f);
     iqSpectrum = new IQSpectrum(panePos, paneSize, &dataBuffer);
@@ -272,6 +381,15 @@ bool Lux::LoadGraphics()
     spectrum = new Spectrum(panePos, paneSize, &dataBuffer);
     spectrumPane = new Pane(panePos, paneSize, &viewer, &sentenceManager, spectrum);
 
+    panePos = glm::vec2(33.0f, -30.0f);
+    waterfallSpectrum = new WaterfallSpectrum(&dataBuffer);
+    waterfallPane = new Pane(panePos, paneSize, &viewer, &sentenceManager, waterfallSpectrum);
+
+    panePos = glm::vec2(-60.0f, 6.0f);
+    paneSize = glm::vec2(92.0f, 20.0f);
+    sweepSpectrum = new SweepSpectrum(panePos, paneSize, &sweepScanner);
+    sweepSpectrumPane = new Pane(panePos, paneSize, &viewer, &sentenceManager, sweepSpectrum);
+
     audioExporter = new AudioExporter(&dataBuffer);
 
     return true;
@@ -288,6 +406,12 @@ void Lux::UnloadGraphics()
     delete spectrumPane;
     delete spectrum;
 
+    delete sweepSpectrumPane;
+    delete sweepSpectrum;
+
+    delete waterfallPane;
+    delete waterfallSpectrum;
+
     delete audioExporter;
 
     glfwDestroyWindow(window);
@@ -301,19 +425,27 @@ bool Lux::Run()
     sf::Time clockStartTime;
     bool focusPaused = false;
     bool escapePaused = false;
+    TRACE_THREAD_NAME("Main");
     while (!glfwWindowShouldClose(window))
     {
         clockStartTime = clock.getElapsedTime();
 
         float frameTime = std::min(frameClock.restart().asSeconds(), 0.06f);
-        HandleEvents(focusPaused, escapePaused);
+        {
+            TRACE_SCOPE("Lux::HandleEvents");
+            HandleEvents(focusPaused, escapePaused);
+        }
 
         // Run the game and render if not paused.
         if (!focusPaused && !escapePaused)
         {
             float gameTime = clock.getElapsedTime().asSeconds();
-            Update(gameTime, frameTime);
+            {
+                TRACE_SCOPE("Lux::Update");
+                Update(gameTime, frameTime);
+            }
 
+            TRACE_SCOPE("Lux::Render");
             Render(viewer.viewMatrix);
             glfwSwapBuffers(window);
         }
@@ -329,11 +461,14 @@ bool Lux::Run()
     return true;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     Logger::Setup("lux-log.log", true);
     Logger::Log("Lux ", AutoVersion::MAJOR_VERSION, ".", AutoVersion::MINOR_VERSION);
 
+    // Messages from the acquisition, filter and audio threads are written from here on by the async logger.
+    AsyncLogger::Start();
+
     Lux* lux = new Lux();
     if (!lux->Initialize())
     {
@@ -361,6 +496,7 @@ int main()
     }
 
     delete lux;
+    AsyncLogger::Stop();
     Logger::Log("Done.");
     Logger::Shutdown();
     return 0;
@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 #include <vector>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -9,11 +10,15 @@
 #include "filters\FrequencySpectrum.h"
 #include "filters\IQSpectrum.h"
 #include "filters\Spectrum.h"
+#include "filters\SweepSpectrum.h"
+#include "filters\WaterfallSpectrum.h"
 #include "sdr\Sdr.h"
 #include "sdr\SdrBuffer.h"
+#include "sdr\SweepScanner.h"
 #include "Pane.h"
 #include "Viewer.h"
 #include "AudioExporter.h"
+#include "SpectrumOccupancyStore.h"
 
 class Lux
 {
@@ -24,6 +29,11 @@ class Lux
 
     Sdr sdr;
     SdrBuffer dataBuffer;
+    SweepScanner sweepScanner;
+    unsigned int preSweepFrequency;
+
+    // Long-term record of the full-band spectrum.
+    SpectrumOccupancyStore occupancyStore;
 
     // Pane-based display items.
     FrequencySpectrum* fourierFilter;
@@ -35,7 +45,16 @@ class Lux
     Spectrum* spectrum;
     Pane* spectrumPane;
 
+    SweepSpectrum* sweepSpectrum;
+    Pane* sweepSpectrumPane;
+
+    WaterfallSpectrum* waterfallSpectrum;
+    Pane* waterfallPane;
+
     AudioExporter* audioExporter;
+
+    // Strongest signal detected in the spectrum since the last frame with any detections.
+    std::string detectionSummary;
     
     // Top-level display items.
     float fpsTimeAggregated;
@@ -44,6 +63,8 @@ class Lux
     int dataSpeedSentenceId;
     int mouseToolTipSentenceId;
     void UpdateFps(float frameTime);
+    void UpdateDetections();
+    void ToggleSweep();
 
     bool LoadCoreGlslGraphics();
     void LogSystemSetup();
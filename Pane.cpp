@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cmath>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm\gtc\matrix_transform.hpp>
@@ -7,10 +8,12 @@
 #include "Pane.h"
 
 glm::vec2 Pane::MinSize = glm::vec2(1.0f, 1.0f);
+float Pane::MinVisibleSpan = 1e-4f;
 
 Pane::Pane(glm::vec2 position, glm::vec2 size, Viewer* viewer, SentenceManager* sentenceManager, IPaneRenderable* paneContents)
     : position(position), size(size), viewer(viewer), sentenceManager(sentenceManager), paneContents(paneContents), borderRenderer(false),
-      titleOffset(0.40f), dragging(false), resizing(false)
+      titleOffset(0.40f), dragging(false), resizing(false), visibleStart(0.0f), visibleStop(1.0f), pixelWidth(0),
+      collapsed(false), contentsVisible(true)
 {
     titleSentenceId = sentenceManager->CreateNewSentence();
 
@@ -70,6 +73,61 @@ bool Pane::HasClickedResizer()
         gridPos.y > position.y && gridPos.y < position.y + Pane::MinSize.y);
 }
 
+bool Pane::IsMouseOverContents()
+{
+    glm::vec2 gridPos = viewer->GetGridPos(Input::GetMousePos());
+    return (gridPos.x > position.x && gridPos.x < position.x + size.x &&
+        gridPos.y > position.y && gridPos.y < position.y + size.y);
+}
+
+void Pane::UpdateZoom()
+{
+    float lastStart = visibleStart;
+    float lastStop = visibleStop;
+    if (IsMouseOverContents())
+    {
+        if (Input::GetScrollOffset() != 0.0f)
+        {
+            // Zoom around the mouse, so the point under it stays put.
+            float mouseFraction = (viewer->GetGridPos(Input::GetMousePos()).x - position.x) / size.x;
+            float mousePoint = visibleStart + mouseFraction * (visibleStop - visibleStart);
+            float span = (visibleStop - visibleStart) * std::pow(0.8f, Input::GetScrollOffset());
+            span = std::min(std::max(span, Pane::MinVisibleSpan), 1.0f);
+
+            visibleStart = std::min(std::max(mousePoint - mouseFraction * span, 0.0f), 1.0f - span);
+            visibleStop = visibleStart + span;
+        }
+
+        if (Input::IsMouseButtonClicked(GLFW_MOUSE_BUTTON_MIDDLE))
+        {
+            visibleStart = 0.0f;
+            visibleStop = 1.0f;
+        }
+    }
+
+    int currentPixelWidth = (int)(size.x / viewer->GetUnitsPerPixel());
+    if (lastStart != visibleStart || lastStop != visibleStop || currentPixelWidth != pixelWidth)
+    {
+        pixelWidth = currentPixelWidth;
+        paneContents->SetVisibleRange(visibleStart, visibleStop, pixelWidth);
+    }
+}
+
+void Pane::SetCollapsed(bool isCollapsed)
+{
+    collapsed = isCollapsed;
+}
+
+void Pane::UpdateVisibility()
+{
+    bool visible = !collapsed && viewer->IsVisible(position, size);
+    if (visible != contentsVisible)
+    {
+        contentsVisible = visible;
+        paneContents->SetVisible(visible);
+    }
+}
+
 void Pane::Update(float elapsedTime, float frameTime)
 {
     if (paneContents->HasTitleUpdate())
@@ -121,8 +179,17 @@ void Pane::Update(float elapsedTime, float frameTime)
         }
     }
 
+    if (HasClickedTitle() && Input::IsMouseButtonClicked(GLFW_MOUSE_BUTTON_RIGHT))
+    {
+        collapsed = !collapsed;
+    }
 
-    paneContents->Update(elapsedTime, frameTime);
+    UpdateVisibility();
+    if (contentsVisible)
+    {
+        UpdateZoom();
+        paneContents->Update(elapsedTime, frameTime);
+    }
 }
 
 void Pane::Render(glm::mat4& projectionMatrix, glm::mat4& perspectiveMatrix, glm::mat4& viewMatrix)
@@ -133,6 +200,11 @@ void Pane::Render(glm::mat4& projectionMatrix, glm::mat4& perspectiveMatrix, glm
     glm::mat4 titleSentenceMatrix = glm::translate(glm::mat4(), glm::vec3(position.x, position.y + size.y + titleOffset, 0.0f)) * viewMatrix;
     sentenceManager->RenderSentence(titleSentenceId, perspectiveMatrix, titleSentenceMatrix);
 
+    if (!contentsVisible)
+    {
+        return;
+    }
+
     float borderSize = viewer->GetUnitsPerPixel();
     paneContents->Render(projectionMatrix, position + glm::vec2(borderSize, borderSize), size - glm::vec2(borderSize * 2, borderSize * 2));
 }
@@ -11,6 +11,9 @@ class Pane
 {
     static glm::vec2 MinSize;
 
+    // The narrowest fraction of the contents that can be zoomed into.
+    static float MinVisibleSpan;
+
     Viewer* viewer;
     SentenceManager* sentenceManager;
 
@@ -33,9 +36,24 @@ class Pane
     bool HasClickedTitle();
     bool HasClickedResizer();
 
+    // Horizontal zoom of the contents, as fractions of their full range, zoomed with the mouse wheel.
+    float visibleStart;
+    float visibleStop;
+    int pixelWidth;
+    bool IsMouseOverContents();
+    void UpdateZoom();
+
+    // Collapsed panes, and those off-screen, don't show or update their contents.
+    bool collapsed;
+    bool contentsVisible;
+    void UpdateVisibility();
+
 public:
     Pane(glm::vec2 position, glm::vec2 size, Viewer* viewer, SentenceManager* sentenceManager, IPaneRenderable* paneContents);
 
+    // Collapsing a pane pauses its contents. Right-clicking the title toggles this.
+    void SetCollapsed(bool isCollapsed);
+
     void Update(float elapsedTime, float frameTime);
     void Render(glm::mat4& projectionMatrix, glm::mat4& perspectiveMatrix, glm::mat4& viewMatrix);
 };
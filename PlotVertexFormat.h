@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <glm\vec2.hpp>
+
+// How a point or line renderer lays out its vertices on the GPU.
+enum class PlotVertexFormat
+{
+    // A vec3 position and vec3 color per vertex (24 bytes), from positionBuffer and colorBuffer.
+    PositionColor,
+
+    // A vec2 position per vertex (8 bytes), from points, drawn in the series color.
+    Position2d,
+
+    // A y value per vertex (4 bytes), from values, with evenly spaced x, drawn in the series color.
+    ImplicitX
+};
+
+// A complete set of compact vertices, built on a filter thread and uploaded as a whole by the renderer.
+struct SeriesSnapshot
+{
+    // Filled for the Position2d and ImplicitX formats respectively.
+    std::vector<glm::vec2> points;
+    std::vector<float> values;
+
+    // For the ImplicitX format, the x of value i is xOrigin + i * xStep.
+    float xOrigin;
+    float xStep;
+
+    SeriesSnapshot()
+        : points(), values(), xOrigin(0.0f), xStep(0.0f)
+    {
+    }
+};
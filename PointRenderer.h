@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include <GL/glew.h>
 #include <glm\vec2.hpp>
 #include <glm\vec3.hpp>
@@ -6,6 +7,8 @@
 #include "GuCommon\shaders\ShaderFactory.h"
 #include "GuCommon\vertex\PositionVbo.hpp"
 #include "GuCommon\vertex\ColorVbo.hpp"
+#include "PlotVertexFormat.h"
+#include "StreamingVbo.h"
 
 struct PointRendererProgram
 {
@@ -14,6 +17,14 @@ struct PointRendererProgram
     GLuint projMatrixLocation;
     GLuint pointSizeLocation;
     GLuint transparencyLocation;
+
+    // Draws the compact vertex formats, with the color as a uniform.
+    GLuint seriesProgramId;
+
+    GLuint seriesProjMatrixLocation;
+    GLuint seriesPointSizeLocation;
+    GLuint seriesColorLocation;
+    GLuint implicitXLocation;
 };
 
 // Renders points.
@@ -24,17 +35,46 @@ class PointRenderer
     GLuint vao;
     std::size_t lastBufferSize;
 
+    // When non-zero, the buffers are streamed into fixed-size GPU storage rather than reallocated on every update.
+    std::size_t streamingCapacity;
+    PlotVertexFormat format;
+    StreamingVbo<glm::vec3> positionStream;
+    StreamingVbo<glm::vec3> colorStream;
+    StreamingVbo<glm::vec2> pointStream;
+    StreamingVbo<float> valueStream;
+
+    glm::vec3 seriesColor;
+    float xOrigin;
+    float xStep;
+    void UploadCompact(const std::vector<glm::vec2>& points, const std::vector<float>& values);
+
 public:
     static bool LoadProgram(ShaderFactory* shaderFactory);
 
+    // Filled for the PositionColor format.
     PositionVbo positionBuffer;
     ColorVbo colorBuffer;
 
-    PointRenderer();
+    // Filled for the Position2d and ImplicitX formats respectively.
+    std::vector<glm::vec2> points;
+    std::vector<float> values;
+
+    // A streaming capacity suits points replaced every block: up to that many are streamed, with no GPU reallocation.
+    // The compact formats are always streamed, so need a capacity.
+    PointRenderer(std::size_t streamingCapacity = 0, PlotVertexFormat format = PlotVertexFormat::PositionColor);
+
+    // Sets the color of every point in the compact formats.
+    void SetSeriesColor(glm::vec3 color);
+
+    // Sets the x of value i to origin + i * step, for the ImplicitX format.
+    void SetImplicitX(float origin, float step);
 
     // Updates the GPU with whatever is currently in the point buffers.
     void Update();
 
+    // Updates the GPU with a snapshot in this renderer's compact format, including its implicit x.
+    void Update(const SeriesSnapshot& snapshot);
+
     // Renders the points in the provided buffers.
     void Render(glm::mat4& projectionMatrix);
 
@@ -0,0 +1,492 @@
+#include <algorithm>
+#include <cstring>
+#include "logging\Logger.h"
+#include "SpectrumOccupancyStore.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char storeMagic[8] = { 'L', 'U', 'X', 'O', 'C', 'C', 'U', 'P' };
+    const std::uint32_t storeVersion = 1;
+
+    // Records kept, and the interval each rolls up in milliseconds, for each resolution. 12000 frames is 10 minutes at 20 spectra/s.
+    const std::uint32_t tierCapacities[] = { 12000, 3600, 1440, 720 };
+    const std::uint32_t tierIntervals[] = { 0, 1000, 60 * 1000, 60 * 60 * 1000 };
+
+    // Set on roll-ups written by Close before their interval ended.
+    const std::uint32_t partialRecordFlag = 1;
+}
+
+SpectrumOccupancyStore::SpectrumOccupancyStore()
+    : storeLock(), binCount(0), fileHandle(-1), mappingHandle(nullptr), mapping(nullptr), mappingSize(0), wallClockOffset(0), lastTimestamp(0)
+{
+}
+
+unsigned char SpectrumOccupancyStore::Quantize(float decibels)
+{
+    return (unsigned char)std::min(std::max((decibels + 127.5f) * 2.0f + 0.5f, 0.0f), 255.0f);
+}
+
+float SpectrumOccupancyStore::Dequantize(unsigned char value)
+{
+    return (float)value * 0.5f - 127.5f;
+}
+
+SpectrumOccupancyStore::FileHeader* SpectrumOccupancyStore::GetHeader() const
+{
+    return (FileHeader*)mapping;
+}
+
+unsigned char* SpectrumOccupancyStore::GetRecord(unsigned int tier, unsigned int index) const
+{
+    const TierHeader& tierHeader = GetHeader()->tiers[tier];
+    return mapping + tierHeader.offset + (std::size_t)index * tierHeader.recordSize;
+}
+
+bool SpectrumOccupancyStore::MapFile(const std::string& path, std::size_t size, bool& created)
+{
+    void* view = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        Logger::LogError("Could not open the occupancy store ", path, ": ", GetLastError());
+        return false;
+    }
+
+    // A store of a different size has another layout, so is recreated at the right size.
+    LARGE_INTEGER existingSize;
+    created = !GetFileSizeEx(file, &existingSize) || (std::size_t)existingSize.QuadPart != size;
+    if (created)
+    {
+        LARGE_INTEGER newSize;
+        newSize.QuadPart = (LONGLONG)size;
+        SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN);
+        SetEndOfFile(file);
+    }
+
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)((std::uint64_t)size >> 32), (DWORD)size, nullptr);
+    if (fileMapping != nullptr)
+    {
+        view = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    }
+
+    if (view == nullptr)
+    {
+        Logger::LogError("Could not map the occupancy store ", path, ": ", GetLastError());
+        if (fileMapping != nullptr)
+        {
+            CloseHandle(fileMapping);
+        }
+
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = (std::intptr_t)file;
+    mappingHandle = fileMapping;
+#else
+    int file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0)
+    {
+        Logger::LogError("Could not open the occupancy store ", path);
+        return false;
+    }
+
+    struct stat fileStatus;
+    created = fstat(file, &fileStatus) != 0 || (std::size_t)fileStatus.st_size != size;
+    if (created && ftruncate(file, (off_t)size) != 0)
+    {
+        Logger::LogError("Could not resize the occupancy store ", path);
+        close(file);
+        return false;
+    }
+
+    view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED)
+    {
+        Logger::LogError("Could not map the occupancy store ", path);
+        close(file);
+        return false;
+    }
+
+    fileHandle = file;
+#endif
+
+    mapping = (unsigned char*)view;
+    mappingSize = size;
+    return true;
+}
+
+void SpectrumOccupancyStore::UnmapFile()
+{
+    if (mapping == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    FlushViewOfFile(mapping, 0);
+    UnmapViewOfFile(mapping);
+    CloseHandle((HANDLE)mappingHandle);
+    CloseHandle((HANDLE)fileHandle);
+#else
+    msync(mapping, mappingSize, MS_SYNC);
+    munmap(mapping, mappingSize);
+    close((int)fileHandle);
+#endif
+
+    fileHandle = -1;
+    mappingHandle = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+}
+
+bool SpectrumOccupancyStore::Open(const std::string& path, unsigned int binCount)
+{
+    Close();
+
+    // Lay out each tier's ring after the header, with records padded to 8 bytes.
+    FileHeader layout;
+    std::memset(&layout, 0, sizeof(layout));
+    std::memcpy(layout.magic, storeMagic, sizeof(storeMagic));
+    layout.version = storeVersion;
+    layout.binCount = binCount;
+
+    std::uint64_t offset = sizeof(FileHeader);
+    for (unsigned int tier = 0; tier < resolutionCount; tier++)
+    {
+        std::uint32_t valueCount = tier == 0 ? binCount : binCount * 3;
+        layout.tiers[tier].offset = offset;
+        layout.tiers[tier].capacity = tierCapacities[tier];
+        layout.tiers[tier].recordSize = ((std::uint32_t)sizeof(RecordHeader) + valueCount + 7) & ~7u;
+        layout.tiers[tier].intervalMilliseconds = tierIntervals[tier];
+        offset += (std::uint64_t)layout.tiers[tier].capacity * layout.tiers[tier].recordSize;
+    }
+
+    storeLock.lock();
+    bool created = false;
+    if (!MapFile(path, (std::size_t)offset, created))
+    {
+        storeLock.unlock();
+        return false;
+    }
+
+    // Keep existing records only if the layout matches exactly.
+    FileHeader* header = GetHeader();
+    bool compatible = !created && std::memcmp(header->magic, storeMagic, sizeof(storeMagic)) == 0 && header->version == storeVersion && header->binCount == binCount;
+    for (unsigned int tier = 0; compatible && tier < resolutionCount; tier++)
+    {
+        compatible = header->tiers[tier].offset == layout.tiers[tier].offset && header->tiers[tier].capacity == layout.tiers[tier].capacity &&
+            header->tiers[tier].recordSize == layout.tiers[tier].recordSize && header->tiers[tier].intervalMilliseconds == layout.tiers[tier].intervalMilliseconds &&
+            header->tiers[tier].nextRecord < layout.tiers[tier].capacity && header->tiers[tier].recordCount <= layout.tiers[tier].capacity;
+    }
+
+    if (!compatible)
+    {
+        *header = layout;
+    }
+
+    this->binCount = binCount;
+    for (Accumulator& accumulator : accumulators)
+    {
+        accumulator.minimums.resize(binCount);
+        accumulator.sums.resize(binCount);
+        accumulator.maximums.resize(binCount);
+        ResetAccumulator(accumulator);
+    }
+
+    for (unsigned int tier = 1; compatible && tier < resolutionCount; tier++)
+    {
+        RestorePartialRecord(tier);
+    }
+
+    std::chrono::milliseconds systemNow = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+    std::chrono::milliseconds steadyNow = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+    wallClockOffset = (systemNow - steadyNow).count();
+
+    const TierHeader& frameTier = header->tiers[0];
+    lastTimestamp = frameTier.recordCount == 0 ? 0 : ((const RecordHeader*)GetRecord(0, (frameTier.nextRecord + frameTier.capacity - 1) % frameTier.capacity))->timestamp;
+
+    unsigned int frameCount = header->tiers[0].recordCount;
+    storeLock.unlock();
+
+    Logger::Log(compatible ? "Reopened" : "Created", " the occupancy store ", path, " (", offset / (1024 * 1024), " MiB, ", frameCount, " frames).");
+    return true;
+}
+
+void SpectrumOccupancyStore::Close()
+{
+    storeLock.lock();
+    if (mapping != nullptr)
+    {
+        // Write out the intervals in progress, marked partial, so the last data before closing isn't lost.
+        // Each holds only what has reached its own tier, so reopening can restore and complete them without counting anything twice.
+        for (unsigned int tier = 1; tier < resolutionCount; tier++)
+        {
+            if (accumulators[tier].frameCount != 0)
+            {
+                WriteRecord(tier, accumulators[tier], true);
+                ResetAccumulator(accumulators[tier]);
+            }
+        }
+    }
+
+    UnmapFile();
+    storeLock.unlock();
+}
+
+bool SpectrumOccupancyStore::IsOpen() const
+{
+    return mapping != nullptr;
+}
+
+void SpectrumOccupancyStore::ResetAccumulator(Accumulator& accumulator)
+{
+    accumulator.startTime = 0;
+    accumulator.centerFrequency = 0;
+    accumulator.sampleRate = 0;
+    accumulator.frameCount = 0;
+    std::fill(accumulator.minimums.begin(), accumulator.minimums.end(), (unsigned char)255);
+    std::fill(accumulator.sums.begin(), accumulator.sums.end(), 0);
+    std::fill(accumulator.maximums.begin(), accumulator.maximums.end(), (unsigned char)0);
+}
+
+void SpectrumOccupancyStore::WriteRecord(unsigned int tier, const Accumulator& accumulator, bool partial)
+{
+    TierHeader& tierHeader = GetHeader()->tiers[tier];
+    unsigned char* record = GetRecord(tier, tierHeader.nextRecord);
+
+    RecordHeader* recordHeader = (RecordHeader*)record;
+    recordHeader->timestamp = accumulator.startTime;
+    recordHeader->centerFrequency = accumulator.centerFrequency;
+    recordHeader->sampleRate = accumulator.sampleRate;
+    recordHeader->frameCount = accumulator.frameCount;
+    recordHeader->flags = partial ? partialRecordFlag : 0;
+
+    unsigned char* values = record + sizeof(RecordHeader);
+    if (tier == 0)
+    {
+        std::memcpy(values, accumulator.minimums.data(), binCount);
+    }
+    else
+    {
+        std::memcpy(values, accumulator.minimums.data(), binCount);
+        for (unsigned int i = 0; i < binCount; i++)
+        {
+            values[binCount + i] = (unsigned char)((accumulator.sums[i] + accumulator.frameCount / 2) / accumulator.frameCount);
+        }
+
+        std::memcpy(values + 2 * binCount, accumulator.maximums.data(), binCount);
+    }
+
+    // The ring position only advances once the record is complete.
+    tierHeader.nextRecord = (tierHeader.nextRecord + 1) % tierHeader.capacity;
+    tierHeader.recordCount = std::min(tierHeader.recordCount + 1, tierHeader.capacity);
+}
+
+void SpectrumOccupancyStore::RestorePartialRecord(unsigned int tier)
+{
+    // Only the newest record of a tier can be partial.
+    TierHeader& tierHeader = GetHeader()->tiers[tier];
+    unsigned int newest = (tierHeader.nextRecord + tierHeader.capacity - 1) % tierHeader.capacity;
+    const unsigned char* record = GetRecord(tier, newest);
+    const RecordHeader* recordHeader = (const RecordHeader*)record;
+    if (tierHeader.recordCount == 0 || (recordHeader->flags & partialRecordFlag) == 0 || recordHeader->frameCount == 0)
+    {
+        return;
+    }
+
+    // The sums are rebuilt from the quantized means, so are within half a step of the originals.
+    Accumulator& accumulator = accumulators[tier];
+    const unsigned char* values = record + sizeof(RecordHeader);
+    accumulator.startTime = recordHeader->timestamp;
+    accumulator.centerFrequency = recordHeader->centerFrequency;
+    accumulator.sampleRate = recordHeader->sampleRate;
+    accumulator.frameCount = recordHeader->frameCount;
+    for (unsigned int i = 0; i < binCount; i++)
+    {
+        accumulator.minimums[i] = values[i];
+        accumulator.sums[i] = (std::uint32_t)values[binCount + i] * recordHeader->frameCount;
+        accumulator.maximums[i] = values[2 * binCount + i];
+    }
+
+    // The record is written again, complete, once its interval ends.
+    tierHeader.nextRecord = newest;
+    tierHeader.recordCount--;
+}
+
+void SpectrumOccupancyStore::Accumulate(unsigned int tier, const Accumulator& source)
+{
+    Accumulator& accumulator = accumulators[tier];
+    std::int64_t interval = (std::int64_t)tierIntervals[tier];
+
+    // Finish the current interval once the source is past it, or from a different tuning.
+    if (accumulator.frameCount != 0 &&
+        (source.startTime < accumulator.startTime || source.startTime >= accumulator.startTime + interval ||
+         source.centerFrequency != accumulator.centerFrequency || source.sampleRate != accumulator.sampleRate))
+    {
+        WriteRecord(tier, accumulator, false);
+        if (tier + 1 < resolutionCount)
+        {
+            Accumulate(tier + 1, accumulator);
+        }
+
+        ResetAccumulator(accumulator);
+    }
+
+    if (accumulator.frameCount == 0)
+    {
+        // Align intervals to whole seconds, minutes and hours.
+        accumulator.startTime = source.startTime - source.startTime % interval;
+        accumulator.centerFrequency = source.centerFrequency;
+        accumulator.sampleRate = source.sampleRate;
+    }
+
+    for (unsigned int i = 0; i < binCount; i++)
+    {
+        accumulator.minimums[i] = std::min(accumulator.minimums[i], source.minimums[i]);
+        accumulator.sums[i] += source.sums[i];
+        accumulator.maximums[i] = std::max(accumulator.maximums[i], source.maximums[i]);
+    }
+
+    accumulator.frameCount += source.frameCount;
+}
+
+bool SpectrumOccupancyStore::Ingest(const std::vector<float>& powerDb, unsigned int centerFrequency, unsigned int sampleRate, std::chrono::steady_clock::time_point captureTime)
+{
+    storeLock.lock();
+    if (mapping == nullptr || powerDb.size() != binCount)
+    {
+        storeLock.unlock();
+        return false;
+    }
+
+    // The frame tier's accumulator holds just this frame, which then feeds the first roll-up.
+    Accumulator& frame = accumulators[0];
+    // The rings are searched by time, so a frame never precedes the last, even if the wall clock went back between runs.
+    std::int64_t captureMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(captureTime.time_since_epoch()).count();
+    lastTimestamp = std::max(wallClockOffset + captureMilliseconds, lastTimestamp);
+    frame.startTime = lastTimestamp;
+    frame.centerFrequency = centerFrequency;
+    frame.sampleRate = sampleRate;
+    frame.frameCount = 1;
+    for (unsigned int i = 0; i < binCount; i++)
+    {
+        unsigned char value = Quantize(powerDb[i]);
+        frame.minimums[i] = value;
+        frame.sums[i] = value;
+        frame.maximums[i] = value;
+    }
+
+    WriteRecord(0, frame, false);
+    Accumulate(1, frame);
+    storeLock.unlock();
+    return true;
+}
+
+unsigned int SpectrumOccupancyStore::Query(OccupancyResolution resolution, std::chrono::system_clock::time_point startTime, std::chrono::system_clock::time_point endTime, std::vector<OccupancyRecord>& records)
+{
+    records.clear();
+    std::int64_t start = std::chrono::duration_cast<std::chrono::milliseconds>(startTime.time_since_epoch()).count();
+    std::int64_t end = std::chrono::duration_cast<std::chrono::milliseconds>(endTime.time_since_epoch()).count();
+    unsigned int tier = (unsigned int)resolution;
+
+    storeLock.lock();
+    if (mapping == nullptr)
+    {
+        storeLock.unlock();
+        return 0;
+    }
+
+    const TierHeader& tierHeader = GetHeader()->tiers[tier];
+    unsigned int oldest = (tierHeader.nextRecord + tierHeader.capacity - tierHeader.recordCount) % tierHeader.capacity;
+    auto getTimestamp = [&](unsigned int age)
+    {
+        return ((const RecordHeader*)GetRecord(tier, (oldest + age) % tierHeader.capacity))->timestamp;
+    };
+
+    // Records are in time order around the ring, so binary search for the first in range.
+    unsigned int low = 0;
+    unsigned int high = tierHeader.recordCount;
+    while (low < high)
+    {
+        unsigned int middle = (low + high) / 2;
+        if (getTimestamp(middle) < start)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    for (unsigned int age = low; age < tierHeader.recordCount && getTimestamp(age) < end; age++)
+    {
+        const unsigned char* record = GetRecord(tier, (oldest + age) % tierHeader.capacity);
+        const RecordHeader* recordHeader = (const RecordHeader*)record;
+        const unsigned char* values = record + sizeof(RecordHeader);
+
+        OccupancyRecord result;
+        result.timestamp = recordHeader->timestamp;
+        result.centerFrequency = recordHeader->centerFrequency;
+        result.sampleRate = recordHeader->sampleRate;
+        result.frameCount = recordHeader->frameCount;
+        result.partial = (recordHeader->flags & partialRecordFlag) != 0;
+        result.minDb.resize(binCount);
+        result.meanDb.resize(binCount);
+        result.maxDb.resize(binCount);
+
+        const unsigned char* minimums = values;
+        const unsigned char* means = tier == 0 ? values : values + binCount;
+        const unsigned char* maximums = tier == 0 ? values : values + 2 * binCount;
+        for (unsigned int i = 0; i < binCount; i++)
+        {
+            result.minDb[i] = Dequantize(minimums[i]);
+            result.meanDb[i] = Dequantize(means[i]);
+            result.maxDb[i] = Dequantize(maximums[i]);
+        }
+
+        records.push_back(std::move(result));
+    }
+
+    storeLock.unlock();
+    return (unsigned int)records.size();
+}
+
+OccupancyResolution SpectrumOccupancyStore::GetFinestResolution(std::chrono::system_clock::time_point startTime)
+{
+    std::int64_t start = std::chrono::duration_cast<std::chrono::milliseconds>(startTime.time_since_epoch()).count();
+
+    storeLock.lock();
+    unsigned int finestTier = resolutionCount - 1;
+    for (unsigned int tier = 0; mapping != nullptr && tier < resolutionCount; tier++)
+    {
+        const TierHeader& tierHeader = GetHeader()->tiers[tier];
+        unsigned int oldest = (tierHeader.nextRecord + tierHeader.capacity - tierHeader.recordCount) % tierHeader.capacity;
+        if (tierHeader.recordCount != 0 && ((const RecordHeader*)GetRecord(tier, oldest))->timestamp <= start)
+        {
+            finestTier = tier;
+            break;
+        }
+    }
+
+    storeLock.unlock();
+    return (OccupancyResolution)finestTier;
+}
+
+SpectrumOccupancyStore::~SpectrumOccupancyStore()
+{
+    Close();
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Time resolutions kept by the occupancy store, finest first.
+enum class OccupancyResolution
+{
+    // Every spectrum ingested, for the last 10 minutes.
+    Frame = 0,
+
+    // Min/mean/max of each second for the last hour, of each minute for the last day, and of each hour for the last 30 days.
+    Second = 1,
+    Minute = 2,
+    Hour = 3
+};
+
+// A spectrum, or a roll-up of the spectra within one interval. Frame records have identical min, mean and max.
+struct OccupancyRecord
+{
+    // Start of the interval, in milliseconds since the Unix epoch.
+    std::int64_t timestamp;
+
+    unsigned int centerFrequency;
+    unsigned int sampleRate;
+    unsigned int frameCount;
+
+    // True for a roll-up whose interval was still in progress when the store was closed. Reopening the store completes it.
+    bool partial;
+
+    // Power of each bin in dBFS, quantized to 0.5 dB from -127.5 to 0, lowest frequency first.
+    std::vector<float> minDb;
+    std::vector<float> meanDb;
+    std::vector<float> maxDb;
+};
+
+// Persists power spectra to a fixed-size memory-mapped file, as a ring of full-resolution frames and rings of
+//  min/mean/max roll-ups at coarser resolutions, so disk and RAM use stay bounded however long Lux runs.
+// Ingest only writes a few KiB into the mapping per spectrum. Roll-ups restart whenever the tuning changes,
+//  so a record never mixes frequency ranges.
+// Records are stamped from each spectrum's monotonic capture time, mapped to the wall clock once when the store is opened,
+//  so wall clock adjustments can't put the rings out of time order.
+class SpectrumOccupancyStore
+{
+    static const unsigned int resolutionCount = 4;
+
+    struct TierHeader
+    {
+        std::uint64_t offset;
+        std::uint32_t capacity;
+        std::uint32_t recordSize;
+        std::uint32_t intervalMilliseconds;
+        std::uint32_t nextRecord;
+        std::uint32_t recordCount;
+        std::uint32_t reserved;
+    };
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t binCount;
+        TierHeader tiers[resolutionCount];
+    };
+
+    struct RecordHeader
+    {
+        std::int64_t timestamp;
+        std::uint32_t centerFrequency;
+        std::uint32_t sampleRate;
+        std::uint32_t frameCount;
+        std::uint32_t flags;
+    };
+
+    // Running min, sum and max of the quantized frames in the current interval of a roll-up tier.
+    struct Accumulator
+    {
+        std::int64_t startTime;
+        unsigned int centerFrequency;
+        unsigned int sampleRate;
+        unsigned int frameCount;
+        std::vector<unsigned char> minimums;
+        std::vector<std::uint32_t> sums;
+        std::vector<unsigned char> maximums;
+    };
+
+    std::mutex storeLock;
+    unsigned int binCount;
+
+    // Platform file and mapping handles.
+    std::intptr_t fileHandle;
+    void* mappingHandle;
+    unsigned char* mapping;
+    std::size_t mappingSize;
+
+    // Index 0 holds the frame being ingested; the rest, the interval in progress at each roll-up resolution.
+    Accumulator accumulators[resolutionCount];
+
+    // Milliseconds from the steady clock's epoch to the Unix epoch, as of opening the store.
+    std::int64_t wallClockOffset;
+
+    // Timestamp of the newest frame, which later frames never precede.
+    std::int64_t lastTimestamp;
+
+    FileHeader* GetHeader() const;
+    unsigned char* GetRecord(unsigned int tier, unsigned int index) const;
+    bool MapFile(const std::string& path, std::size_t size, bool& created);
+    void UnmapFile();
+
+    // Appends a record to a tier's ring. Roll-up tiers write min, mean, max; the frame tier only the values.
+    void WriteRecord(unsigned int tier, const Accumulator& accumulator, bool partial);
+
+    // Moves a partial record left by Close back into the tier's accumulator, so its interval is completed rather than written twice.
+    void RestorePartialRecord(unsigned int tier);
+
+    // Adds a finished interval from the tier below (or a single frame, to the first roll-up tier) into a tier.
+    void Accumulate(unsigned int tier, const Accumulator& source);
+    void ResetAccumulator(Accumulator& accumulator);
+
+    static unsigned char Quantize(float decibels);
+    static float Dequantize(unsigned char value);
+
+public:
+    SpectrumOccupancyStore();
+    ~SpectrumOccupancyStore();
+
+    // Opens the store, reusing its contents if it was created with the same bin count, otherwise recreating it.
+    bool Open(const std::string& path, unsigned int binCount);
+    void Close();
+    bool IsOpen() const;
+
+    // Adds one power spectrum, in dBFS, lowest frequency first, captured at the provided time. Thread-safe.
+    bool Ingest(const std::vector<float>& powerDb, unsigned int centerFrequency, unsigned int sampleRate, std::chrono::steady_clock::time_point captureTime);
+
+    // Retrieves the records at a resolution starting within [startTime, endTime), oldest first. Thread-safe.
+    // Returns the number of records retrieved.
+    unsigned int Query(OccupancyResolution resolution, std::chrono::system_clock::time_point startTime, std::chrono::system_clock::time_point endTime, std::vector<OccupancyRecord>& records);
+
+    // Returns the finest resolution whose records still reach back to the start time.
+    OccupancyResolution GetFinestResolution(std::chrono::system_clock::time_point startTime);
+};
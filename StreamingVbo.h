@@ -0,0 +1,140 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <GL/glew.h>
+#include "logging\Logger.h"
+
+// Vertex buffer for data that is replaced wholesale, such as a filter's output each block.
+// Storage is allocated once at a fixed capacity, so uploads never reallocate GPU memory. Where buffer storage
+//  (GL 4.4, or ARB_buffer_storage) is available, the buffer is persistently mapped as a ring of regions, each
+//  guarded by a fence so a region is only rewritten once the GPU has finished drawing from it.
+//  Otherwise the buffer is orphaned before each upload, so the driver can hand back fresh memory without stalling.
+template<typename T>
+class StreamingVbo
+{
+    static const unsigned int regionCount = 3;
+
+    GLuint buffer;
+    std::size_t capacity;
+
+    bool persistent;
+    T* mappedRegions;
+    GLsync fences[regionCount];
+    unsigned int currentRegion;
+
+    std::size_t vertexCount;
+    bool warnedOfOverflow;
+
+public:
+    StreamingVbo()
+        : buffer(0), capacity(0), persistent(false), mappedRegions(nullptr), currentRegion(0), vertexCount(0), warnedOfOverflow(false)
+    {
+        for (unsigned int i = 0; i < regionCount; i++)
+        {
+            fences[i] = nullptr;
+        }
+    }
+
+    // Creates the buffer, bound to the attribute of the currently bound VAO. T must be componentCount floats.
+    void Initialize(GLuint attributeIndex, GLint componentCount, std::size_t capacity)
+    {
+        this->capacity = capacity;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        persistent = GLEW_ARB_buffer_storage != 0;
+        if (persistent)
+        {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, regionCount * capacity * sizeof(T), nullptr, flags);
+            mappedRegions = (T*)glMapBufferRange(GL_ARRAY_BUFFER, 0, regionCount * capacity * sizeof(T), flags);
+            persistent = mappedRegions != nullptr;
+        }
+
+        if (!persistent)
+        {
+            glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(T), nullptr, GL_STREAM_DRAW);
+        }
+
+        glEnableVertexAttribArray(attributeIndex);
+        glVertexAttribPointer(attributeIndex, componentCount, GL_FLOAT, GL_FALSE, sizeof(T), (void*)0);
+    }
+
+    // Copies vertices into GPU-visible memory, replacing the last upload. Vertices beyond the capacity are dropped.
+    void Upload(const T* vertices, std::size_t count)
+    {
+        if (count > capacity && !warnedOfOverflow)
+        {
+            Logger::LogWarn("Streaming ", count, " vertices into a buffer with capacity for ", capacity, "; the excess will not be drawn.");
+            warnedOfOverflow = true;
+        }
+
+        vertexCount = std::min(count, capacity);
+        if (persistent)
+        {
+            // Move on to the next region, waiting for the GPU if it is still drawing from it.
+            currentRegion = (currentRegion + 1) % regionCount;
+            if (fences[currentRegion] != nullptr)
+            {
+                glClientWaitSync(fences[currentRegion], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                glDeleteSync(fences[currentRegion]);
+                fences[currentRegion] = nullptr;
+            }
+
+            std::memcpy(mappedRegions + currentRegion * capacity, vertices, vertexCount * sizeof(T));
+        }
+        else
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(T), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount * sizeof(T), vertices);
+        }
+    }
+
+    // Marks the current region as in use by the draw calls just issued. Call after each draw from this buffer.
+    void Fence()
+    {
+        if (persistent)
+        {
+            if (fences[currentRegion] != nullptr)
+            {
+                glDeleteSync(fences[currentRegion]);
+            }
+
+            fences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    // Index of the first vertex of the last upload, to draw from.
+    GLint GetFirstVertex() const
+    {
+        return persistent ? (GLint)(currentRegion * capacity) : 0;
+    }
+
+    std::size_t GetVertexCount() const
+    {
+        return vertexCount;
+    }
+
+    void Deinitialize()
+    {
+        for (unsigned int i = 0; i < regionCount; i++)
+        {
+            if (fences[i] != nullptr)
+            {
+                glDeleteSync(fences[i]);
+                fences[i] = nullptr;
+            }
+        }
+
+        if (persistent)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            mappedRegions = nullptr;
+        }
+
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+};
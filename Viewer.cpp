@@ -110,6 +110,23 @@ glm::vec2 Viewer::GetGridPos(glm::vec2 screenPos)
     return (gridPos - glm::vec2(GetXSize() / 2.0f, GetYSize() / 2.0f)) * glm::vec2(1.0f, -1.0f);
 }
 
+bool Viewer::IsVisible(glm::vec2 position, glm::vec2 size)
+{
+    // A minimized window has no screen.
+    if (ScreenWidth <= 0 || ScreenHeight <= 0)
+    {
+        return false;
+    }
+
+    // Letterboxing shows more than the nominal X/Y size along one axis, so go by the extent of the screen itself.
+    float unitsPerPixel = GetUnitsPerPixel();
+    float halfWidth = (float)ScreenWidth * unitsPerPixel / 2.0f;
+    float halfHeight = (float)ScreenHeight * unitsPerPixel / 2.0f;
+
+    return position.x < target.x + halfWidth && position.x + size.x > target.x - halfWidth &&
+        position.y < target.y + halfHeight && position.y + size.y > target.y - halfHeight;
+}
+
 float Viewer::GetXSize()
 {
     if (useCache)
@@ -55,6 +55,9 @@ public:
     glm::vec2 GetGridPos(glm::ivec2 screenPos);
     float GetAspectRatio() const;
 
+    // Returns true if any of the rectangle on the XY plane is on screen.
+    bool IsVisible(glm::vec2 position, glm::vec2 size);
+
     // Returns the total X/Y size of hte display
     float GetXSize();
     float GetYSize();
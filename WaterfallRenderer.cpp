@@ -0,0 +1,111 @@
+#include <vector>
+#include "logging\Logger.h"
+#include "WaterfallRenderer.h"
+
+WaterfallRendererProgram WaterfallRenderer::glslProgram;
+
+bool WaterfallRenderer::LoadProgram(ShaderFactory* shaderFactory)
+{
+    Logger::Log("Loading the waterfall rendering shading program...");
+    if (!shaderFactory->CreateShaderProgram("waterfall", &glslProgram.programId))
+    {
+        Logger::LogError("Failed to load the waterfall rendering shader; cannot continue.");
+        return false;
+    }
+
+    glslProgram.projMatrixLocation = glGetUniformLocation(glslProgram.programId, "projMatrix");
+    glslProgram.historyTextureLocation = glGetUniformLocation(glslProgram.programId, "historyTexture");
+    glslProgram.rowMappingLocation = glGetUniformLocation(glslProgram.programId, "rowMapping");
+    glslProgram.visibleRangeLocation = glGetUniformLocation(glslProgram.programId, "visibleRange");
+
+    return true;
+}
+
+WaterfallRenderer::WaterfallRenderer(unsigned int columns, unsigned int rows)
+    : columns(columns), rows(rows), nextRow(0), lastPosition(0.0f, 0.0f), lastSize(0.0f, 0.0f)
+{
+    // One quad of interleaved positions (xyz) and UVs, drawn as a triangle strip.
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, 4 * 5 * sizeof(GLfloat), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+
+    // Single-channel bytes keep each row upload to one byte per bin, and R8 is supported by every GL 3+ driver, Mesa's included.
+    // Linear filtering blends neighbouring bins when the pane is narrower than the spectrum, rather than dropping them.
+    std::vector<unsigned char> blankRows((std::size_t)columns * rows, 0);
+    glGenTextures(1, &historyTexture);
+    glBindTexture(GL_TEXTURE_2D, historyTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, columns, rows, 0, GL_RED, GL_UNSIGNED_BYTE, blankRows.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+unsigned int WaterfallRenderer::GetColumns() const
+{
+    return columns;
+}
+
+unsigned int WaterfallRenderer::GetRows() const
+{
+    return rows;
+}
+
+void WaterfallRenderer::AddRow(const unsigned char* levels)
+{
+    glBindTexture(GL_TEXTURE_2D, historyTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, nextRow, columns, 1, GL_RED, GL_UNSIGNED_BYTE, levels);
+    nextRow = (nextRow + 1) % rows;
+}
+
+void WaterfallRenderer::Render(glm::mat4& projectionMatrix, glm::vec2 position, glm::vec2 size, float visibleStart, float visibleStop)
+{
+    glUseProgram(glslProgram.programId);
+    glBindVertexArray(vao);
+
+    if (position != lastPosition || size != lastSize)
+    {
+        const GLfloat vertices[] =
+        {
+            position.x, position.y, 0.0f, 0.0f, 0.0f,
+            position.x + size.x, position.y, 0.0f, 1.0f, 0.0f,
+            position.x, position.y + size.y, 0.0f, 0.0f, 1.0f,
+            position.x + size.x, position.y + size.y, 0.0f, 1.0f, 1.0f
+        };
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+        lastPosition = position;
+        lastSize = size;
+    }
+
+    // The newest row is the one before the next to be written. Mapping between row centers keeps linear
+    //  filtering from blending the newest row with the oldest where the ring wraps.
+    unsigned int newestRow = (nextRow + rows - 1) % rows;
+    float newestRowCenter = ((float)newestRow + 0.5f) / (float)rows;
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, historyTexture);
+    glUniform1i(glslProgram.historyTextureLocation, 0);
+    glUniformMatrix4fv(glslProgram.projMatrixLocation, 1, GL_FALSE, &projectionMatrix[0][0]);
+    glUniform2f(glslProgram.rowMappingLocation, newestRowCenter, (float)(rows - 1) / (float)rows);
+    glUniform2f(glslProgram.visibleRangeLocation, visibleStart, visibleStop);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+WaterfallRenderer::~WaterfallRenderer()
+{
+    glDeleteTextures(1, &historyTexture);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm\vec2.hpp>
+#include <glm\mat4x4.hpp>
+#include "GuCommon\shaders\ShaderFactory.h"
+
+struct WaterfallRendererProgram
+{
+    GLuint programId;
+
+    GLuint projMatrixLocation;
+    GLuint historyTextureLocation;
+    GLuint rowMappingLocation;
+    GLuint visibleRangeLocation;
+};
+
+// Renders a scrolling waterfall from a ring texture of spectrum rows, colormapped in the fragment shader.
+// Only new rows are uploaded, so the cost per frame doesn't depend on how much history is kept.
+class WaterfallRenderer
+{
+    static WaterfallRendererProgram glslProgram;
+
+    GLuint vao;
+    GLuint vertexBuffer;
+    GLuint historyTexture;
+
+    unsigned int columns;
+    unsigned int rows;
+    unsigned int nextRow;
+
+    // The quad is only re-uploaded when the pane moves or resizes.
+    glm::vec2 lastPosition;
+    glm::vec2 lastSize;
+
+public:
+    static bool LoadProgram(ShaderFactory* shaderFactory);
+
+    WaterfallRenderer(unsigned int columns, unsigned int rows);
+
+    unsigned int GetColumns() const;
+    unsigned int GetRows() const;
+
+    // Uploads a row of columns levels, from 0 (bottom of the colormap) to 255 (top), replacing the oldest row.
+    void AddRow(const unsigned char* levels);
+
+    // Renders into the provided position and size, showing the horizontal range [visibleStart, visibleStop] of each row.
+    void Render(glm::mat4& projectionMatrix, glm::vec2 position, glm::vec2 size, float visibleStart, float visibleStop);
+
+    ~WaterfallRenderer();
+};
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include "logging\Logger.h"
+#include "BenchmarkSuite.h"
+
+double BenchmarkResult::GetThroughput() const
+{
+    return medianNanoseconds > 0.0 ? 1e3 / medianNanoseconds : 0.0;
+}
+
+BenchmarkSuite::BenchmarkSuite(std::string filter, unsigned int repetitions, float minRepetitionSeconds)
+    : filter(filter), repetitions(std::max(repetitions, 1u)), minRepetitionSeconds(minRepetitionSeconds), results()
+{
+}
+
+bool BenchmarkSuite::IsSelected(const std::string& name) const
+{
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchmarkSuite::Run(const std::string& name, std::size_t samplesPerRun, std::function<void()> run)
+{
+    if (!IsSelected(name))
+    {
+        return;
+    }
+
+    // The first run warms caches and builds any cached plans, so isn't timed.
+    run();
+
+    // Double the runs until a repetition is long enough to time, then scale up to the minimum.
+    unsigned int runsPerRepetition = 1;
+    double calibrationSeconds = 0.0;
+    while (true)
+    {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < runsPerRepetition; i++)
+        {
+            run();
+        }
+
+        calibrationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (calibrationSeconds >= minRepetitionSeconds / 4.0)
+        {
+            break;
+        }
+
+        runsPerRepetition *= 2;
+    }
+
+    runsPerRepetition = std::max(1u, (unsigned int)std::ceil(runsPerRepetition * minRepetitionSeconds / calibrationSeconds));
+
+    std::vector<double> nanosecondsPerSample;
+    for (unsigned int repetition = 0; repetition < repetitions; repetition++)
+    {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < runsPerRepetition; i++)
+        {
+            run();
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        nanosecondsPerSample.push_back(seconds * 1e9 / ((double)runsPerRepetition * samplesPerRun));
+    }
+
+    std::sort(nanosecondsPerSample.begin(), nanosecondsPerSample.end());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.samplesPerRun = samplesPerRun;
+    result.runsPerRepetition = runsPerRepetition;
+    result.repetitions = repetitions;
+    result.minNanoseconds = nanosecondsPerSample.front();
+
+    std::size_t middle = nanosecondsPerSample.size() / 2;
+    result.medianNanoseconds = nanosecondsPerSample.size() % 2 == 0
+        ? (nanosecondsPerSample[middle - 1] + nanosecondsPerSample[middle]) / 2.0 : nanosecondsPerSample[middle];
+
+    double sum = 0.0;
+    for (double value : nanosecondsPerSample)
+    {
+        sum += value;
+    }
+
+    result.meanNanoseconds = sum / nanosecondsPerSample.size();
+
+    double squaredDeviations = 0.0;
+    for (double value : nanosecondsPerSample)
+    {
+        squaredDeviations += (value - result.meanNanoseconds) * (value - result.meanNanoseconds);
+    }
+
+    result.standardDeviationNanoseconds = std::sqrt(squaredDeviations / nanosecondsPerSample.size());
+
+    Logger::Log(name, ": ", result.medianNanoseconds, " ns/sample (min ", result.minNanoseconds, ", sd ", result.standardDeviationNanoseconds,
+        "), ", result.GetThroughput(), " MS/s, ", repetitions, " x ", runsPerRepetition, " runs of ", samplesPerRun, " samples.");
+    results.push_back(result);
+}
+
+const std::vector<BenchmarkResult>& BenchmarkSuite::GetResults() const
+{
+    return results;
+}
+
+bool BenchmarkSuite::WriteJson(const std::string& path, const std::string& label) const
+{
+    std::ofstream json(path);
+    if (!json)
+    {
+        Logger::LogError("Unable to write benchmark results to '", path, "'.");
+        return false;
+    }
+
+    // Names are ours, but the label comes from the command line, so is escaped.
+    std::string escapedLabel;
+    for (char character : label)
+    {
+        if (character == '"' || character == '\\')
+        {
+            escapedLabel += '\\';
+        }
+
+        escapedLabel += character;
+    }
+
+    json.precision(6);
+    json << "{\n  \"label\": \"" << escapedLabel << "\",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        json << (i == 0 ? "\n" : ",\n")
+             << "    { \"name\": \"" << result.name << "\""
+             << ", \"samplesPerRun\": " << result.samplesPerRun
+             << ", \"runsPerRepetition\": " << result.runsPerRepetition
+             << ", \"repetitions\": " << result.repetitions
+             << ", \"nsPerSampleMin\": " << result.minNanoseconds
+             << ", \"nsPerSampleMedian\": " << result.medianNanoseconds
+             << ", \"nsPerSampleMean\": " << result.meanNanoseconds
+             << ", \"nsPerSampleStdDev\": " << result.standardDeviationNanoseconds
+             << ", \"msps\": " << result.GetThroughput() << " }";
+    }
+
+    json << "\n  ]\n}\n";
+    Logger::Log("Wrote ", results.size(), " benchmark results to '", path, "'.");
+    return true;
+}
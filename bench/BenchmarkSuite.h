@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+// Timing of one benchmark, per input sample, across its repetitions.
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t samplesPerRun;
+    unsigned int runsPerRepetition;
+    unsigned int repetitions;
+
+    double minNanoseconds;
+    double medianNanoseconds;
+    double meanNanoseconds;
+    double standardDeviationNanoseconds;
+
+    // Millions of input samples per second at the median time.
+    double GetThroughput() const;
+};
+
+// Runs benchmarks with repetition, so results can be compared between builds.
+// Each benchmark is calibrated to run long enough per repetition for the clock to be accurate, then repeated,
+//  reporting the median (robust to the odd preempted repetition) alongside the spread.
+class BenchmarkSuite
+{
+    std::string filter;
+    unsigned int repetitions;
+    float minRepetitionSeconds;
+
+    std::vector<BenchmarkResult> results;
+
+public:
+    // Only benchmarks whose name contains the filter are run, all of them if it is empty.
+    BenchmarkSuite(std::string filter, unsigned int repetitions, float minRepetitionSeconds);
+
+    bool IsSelected(const std::string& name) const;
+
+    // Times run, which processes samplesPerRun input samples each call, and logs the result.
+    void Run(const std::string& name, std::size_t samplesPerRun, std::function<void()> run);
+
+    const std::vector<BenchmarkResult>& GetResults() const;
+
+    // Writes all results as JSON, tagged with the provided label (such as a commit), for tracking regressions between builds.
+    bool WriteJson(const std::string& path, const std::string& label) const;
+};
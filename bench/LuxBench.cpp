@@ -0,0 +1,490 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logging\Logger.h"
+#include "math\Constants.h"
+#include "math\CustomFilter.h"
+#include "math\FftPlan.h"
+#include "math\FixedPoint.h"
+#include "math\FourierTransform.h"
+#include "math\IqConverter.h"
+#include "math\LargeFourierTransform.h"
+#include "math\PowerSpectrum.h"
+#include "math\SampleBlock.h"
+#include "math\ShortTimeFourierTransform.h"
+#include "math\WindowedSincFilter.h"
+#include "AMAudioTransformer.h"
+#include "FMAudioTransformer.h"
+#include "BenchmarkSuite.h"
+
+#pragma comment(lib, "lib/sfml-system")
+
+// One SdrBuffer read (16 blocks of 16 KiB), the unit most of the pipeline processes at a time.
+static const unsigned int samplesPerBlock = 16 * 16384 / 2;
+
+// Random bytes stand in for the RTL-SDR; the kernels' cost doesn't depend on the signal.
+static SampleBlock<IqByte> CreateRawSamples(std::size_t count)
+{
+    SampleBlock<IqByte> rawSamples(count);
+    std::mt19937 generator(42);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        rawSamples[i].i = (unsigned char)(generator() & 0xFF);
+        rawSamples[i].q = (unsigned char)(generator() & 0xFF);
+    }
+
+    return rawSamples;
+}
+
+static SampleBlock<std::complex<float>> ConvertSamples(const SampleBlock<IqByte>& rawSamples)
+{
+    SampleBlock<std::complex<float>> samples(rawSamples.size());
+    IqConverter converter;
+    converter.Convert(rawSamples.View(), samples.View());
+    return samples;
+}
+
+static SampleBlock<ComplexInt16> ConvertSamplesToInt16(const SampleBlock<IqByte>& rawSamples)
+{
+    SampleBlock<ComplexInt16> samples(rawSamples.size());
+    IqConverter converter;
+    converter.ConvertToInt16(rawSamples.View(), samples.View());
+    return samples;
+}
+
+static void BenchmarkConversion(BenchmarkSuite& suite)
+{
+    SampleBlock<IqByte> rawSamples = CreateRawSamples(samplesPerBlock);
+    SampleBlock<std::complex<float>> output(samplesPerBlock);
+    SampleBlock<ComplexInt16> fixedPointOutput(samplesPerBlock);
+    IqConverter converter;
+
+    // The conversion each filter performed inline before the shared conversion stage existed, and a plain lookup table, for comparison.
+    suite.Run("convert/scalar-inline", samplesPerBlock, [&]()
+    {
+        for (unsigned int i = 0; i < samplesPerBlock; i++)
+        {
+            output[i] = std::complex<float>((float)rawSamples[i].i - 127.5f, (float)rawSamples[i].q - 127.5f);
+        }
+    });
+
+    float lookupTable[256];
+    for (unsigned int i = 0; i < 256; i++)
+    {
+        lookupTable[i] = ((float)i - 127.5f) / 127.5f;
+    }
+
+    suite.Run("convert/lookup", samplesPerBlock, [&]()
+    {
+        for (unsigned int i = 0; i < samplesPerBlock; i++)
+        {
+            output[i] = std::complex<float>(lookupTable[rawSamples[i].i], lookupTable[rawSamples[i].q]);
+        }
+    });
+
+    suite.Run("convert/float", samplesPerBlock, [&]() { converter.Convert(rawSamples.View(), output.View()); });
+    suite.Run("convert/q15", samplesPerBlock, [&]() { converter.ConvertToInt16(rawSamples.View(), fixedPointOutput.View()); });
+}
+
+static void BenchmarkFft(BenchmarkSuite& suite)
+{
+    // Powers of 4 from 64 to 1M, then a mixed-radix (2^3 5^3) and a prime (Bluestein) size near 1024.
+    std::vector<unsigned int> sizes = { 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 1000, 1009 };
+    for (unsigned int size : sizes)
+    {
+        std::string name = "fft/" + std::to_string(size);
+        if (!suite.IsSelected(name))
+        {
+            continue;
+        }
+
+        SampleBlock<std::complex<float>> samples = ConvertSamples(CreateRawSamples(size));
+        SampleBlock<std::complex<float>> spectrum(size);
+        std::shared_ptr<const FftPlan> plan = FftPlan::Get(size, FftDirection::Forward);
+
+        suite.Run(name, size, [&]() { plan->Execute(samples.data(), spectrum.data()); });
+    }
+}
+
+static void BenchmarkLargeFft(BenchmarkSuite& suite)
+{
+    // The six-step transform from one thread up to every hardware thread, against fft/ at the same size for a single plan.
+    // Powers of two, then every hardware thread.
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+
+    threadCounts.push_back(maxThreads);
+
+    std::vector<unsigned int> sizes = { 1 << 20, 1 << 22 };
+    for (unsigned int size : sizes)
+    {
+        std::vector<std::string> names;
+        bool anySelected = false;
+        for (unsigned int threads : threadCounts)
+        {
+            names.push_back("fft-six-step/" + std::to_string(size) + "/" + std::to_string(threads) + "-threads");
+            anySelected = anySelected || suite.IsSelected(names.back());
+        }
+
+        if (!anySelected)
+        {
+            continue;
+        }
+
+        SampleBlock<std::complex<float>> samples = ConvertSamples(CreateRawSamples(size));
+        SampleBlock<std::complex<float>> spectrum;
+        LargeFourierTransform transform(size, 1);
+        for (std::size_t i = 0; i < threadCounts.size(); i++)
+        {
+            transform.SetThreadCount(threadCounts[i]);
+            suite.Run(names[i], size, [&]() { transform.Transform(samples.View(), spectrum); });
+        }
+
+        // Check against a single plan, which is exact to float rounding.
+        SampleBlock<std::complex<float>> directSpectrum(size);
+        FftPlan::Get(size, FftDirection::Forward)->Execute(samples.data(), directSpectrum.data());
+        transform.Transform(samples.View(), spectrum);
+
+        float maxError = 0.0f;
+        for (unsigned int i = 0; i < size; i++)
+        {
+            maxError = std::max(maxError, std::abs(spectrum[i] - directSpectrum[i]));
+        }
+
+        Logger::Log(size, "-point six-step FFT max difference from a single plan: ", maxError, " (", maxError / std::sqrt((float)size), " relative to the RMS bin)");
+    }
+}
+
+static void BenchmarkStft(BenchmarkSuite& suite)
+{
+    // One block in the 1024-point, 50% overlap frames the spectrum uses, batched and then one frame at a time.
+    const unsigned int fftSize = 1024;
+    SampleBlock<std::complex<float>> samples = ConvertSamples(CreateRawSamples(samplesPerBlock));
+
+    ShortTimeFourierTransform transform(fftSize, SpectrumWindow::Blackman, 0.5f);
+    suite.Run("stft/batched-1024", samplesPerBlock, [&]() { transform.Transform(samples.View()); });
+
+    std::vector<float> window(fftSize);
+    for (unsigned int i = 0; i < fftSize; i++)
+    {
+        window[i] = CustomFilter::ComputeBlackmanWindowPt(i, fftSize);
+    }
+
+    SampleBlock<std::complex<float>> windowedFrame(fftSize);
+    std::vector<float> reals;
+    std::vector<float> imags;
+    unsigned int hopSize = transform.GetHopSize();
+    suite.Run("stft/single-1024", samplesPerBlock, [&]()
+    {
+        for (std::size_t position = 0; position + fftSize <= samples.size(); position += hopSize)
+        {
+            for (unsigned int i = 0; i < fftSize; i++)
+            {
+                windowedFrame[i] = samples[position + i] * window[i];
+            }
+
+            FourierTransform::ComplexFFT(windowedFrame.View(), reals, imags);
+        }
+    });
+}
+
+static void BenchmarkFir(BenchmarkSuite& suite)
+{
+    // Each run produces outputLength outputs without decimation, so the cost per sample is the cost per tap times the taps.
+    const unsigned int outputLength = 16384;
+    std::vector<unsigned int> tapCounts = { 16, 64, 256, 1024, 4096 };
+    for (unsigned int taps : tapCounts)
+    {
+        std::string floatName = "fir/float/" + std::to_string(taps);
+        std::string fixedPointName = "fir/q15/" + std::to_string(taps);
+        if (!suite.IsSelected(floatName) && !suite.IsSelected(fixedPointName))
+        {
+            continue;
+        }
+
+        SampleBlock<IqByte> rawSamples = CreateRawSamples(outputLength + taps - 1);
+        SampleBlock<std::complex<float>> samples = ConvertSamples(rawSamples);
+        SampleBlock<ComplexInt16> fixedPointSamples = ConvertSamplesToInt16(rawSamples);
+        SampleBlock<std::complex<float>> output;
+        SampleBlock<ComplexInt16> fixedPointOutput;
+
+        WindowedSincFilter filter;
+        filter.CreateFilter(0.25f, taps);
+
+        suite.Run(floatName, outputLength, [&]() { filter.Decimate(samples.View(), 1, output); });
+        suite.Run(fixedPointName, outputLength, [&]() { filter.DecimateFixedPoint(fixedPointSamples.View(), 1, fixedPointOutput); });
+    }
+}
+
+static void BenchmarkDecimation(BenchmarkSuite& suite)
+{
+    // The decimators the pipeline runs on each block, costed per input sample.
+    SampleBlock<IqByte> rawSamples = CreateRawSamples(samplesPerBlock);
+    SampleBlock<std::complex<float>> samples = ConvertSamples(rawSamples);
+    SampleBlock<ComplexInt16> fixedPointSamples = ConvertSamplesToInt16(rawSamples);
+    SampleBlock<std::complex<float>> output;
+    SampleBlock<std::complex<float>> secondOutput;
+    SampleBlock<ComplexInt16> fixedPointOutput;
+
+    // The IQSpectrum and Spectrum decimators, with kernels as long as their factors.
+    WindowedSincFilter iqFilter;
+    iqFilter.CreateFilter(3710, 1024);
+    suite.Run("decimate/iq-1024", samplesPerBlock, [&]() { iqFilter.Decimate(samples.View(), 1024, output); });
+
+    WindowedSincFilter spectrumFilter;
+    spectrumFilter.CreateFilter(3710, 648);
+    suite.Run("decimate/spectrum-648", samplesPerBlock, [&]() { spectrumFilter.Decimate(samples.View(), 648, output); });
+
+    // The FM baseband filter, 2.4 MS/s to 400 kS/s, in both precisions.
+    WindowedSincFilter basebandFilter;
+    basebandFilter.CreateFilter(100000.0f / 2400000.0f, 48);
+    suite.Run("decimate/fm-baseband-6/float", samplesPerBlock, [&]() { basebandFilter.Decimate(samples.View(), 6, output); });
+    suite.Run("decimate/fm-baseband-6/q15", samplesPerBlock, [&]() { basebandFilter.DecimateFixedPoint(fixedPointSamples.View(), 6, fixedPointOutput); });
+
+    // A two-stage chain down to audio rates, 2.4 MS/s to 400 kS/s to ~44.4 kS/s, against doing it in one stage.
+    WindowedSincFilter audioFilter;
+    audioFilter.CreateFilter(15000.0f / 400000.0f, 64);
+    suite.Run("decimate/chain-6-9", samplesPerBlock, [&]()
+    {
+        basebandFilter.Decimate(samples.View(), 6, output);
+        audioFilter.Decimate(output.View(), 9, secondOutput);
+    });
+
+    WindowedSincFilter singleStageFilter;
+    singleStageFilter.CreateFilter(15000.0f / 2400000.0f, 384);
+    suite.Run("decimate/single-54", samplesPerBlock, [&]() { singleStageFilter.Decimate(samples.View(), 54, output); });
+}
+
+static void BenchmarkSpectrum(BenchmarkSuite& suite)
+{
+    // The FrequencySpectrum's full-band averaged spectrum.
+    SampleBlock<std::complex<float>> samples = ConvertSamples(CreateRawSamples(samplesPerBlock));
+    PowerSpectrum powerSpectrum(1024, SpectrumWindow::Blackman, 0.5f);
+    powerSpectrum.SetAveraging(SpectrumAveraging::Exponential, 0.01f);
+    std::vector<float> power;
+
+    suite.Run("spectrum/power-1024", samplesPerBlock, [&]()
+    {
+        powerSpectrum.AddSamples(samples.View());
+        powerSpectrum.GetPower(power);
+    });
+}
+
+static void BenchmarkDemodulation(BenchmarkSuite& suite)
+{
+    SampleBlock<IqByte> rawSamples = CreateRawSamples(samplesPerBlock);
+    SampleBlock<std::complex<float>> samples = ConvertSamples(rawSamples);
+    std::vector<sf::Int16> audio;
+
+    FMAudioTransformer fmFloat;
+    fmFloat.SetPrecision(DspPrecision::Float);
+    suite.Run("demod/fm/float", samplesPerBlock, [&]()
+    {
+        audio.clear();
+        fmFloat.Process(rawSamples.View(), samples.View(), &audio);
+    });
+
+    FMAudioTransformer fmFixedPoint;
+    fmFixedPoint.SetPrecision(DspPrecision::FixedPoint);
+    suite.Run("demod/fm/q15", samplesPerBlock, [&]()
+    {
+        audio.clear();
+        fmFixedPoint.Process(rawSamples.View(), samples.View(), &audio);
+    });
+
+    AMAudioTransformer am;
+    suite.Run("demod/am", samplesPerBlock, [&]()
+    {
+        audio.clear();
+        am.Process(rawSamples.View(), samples.View(), &audio);
+    });
+}
+
+// Accumulates the error of a fixed-point result against its floating-point reference.
+struct ErrorStatistics
+{
+    double signalPower = 0.0;
+    double errorPower = 0.0;
+    float maxError = 0.0f;
+
+    void Add(float reference, float value)
+    {
+        float error = std::abs(value - reference);
+        signalPower += reference * reference;
+        errorPower += error * error;
+        maxError = std::max(maxError, error);
+    }
+
+    void Log(const char* stage) const
+    {
+        Logger::Log("  ", stage, ": max error ", maxError, ", SNR ", 10.0 * std::log10(signalPower / std::max(errorPower, 1e-30)), " dB");
+    }
+};
+
+// Logs the error of each fixed-point FM stage against its floating-point equivalent on a synthetic broadcast-like signal.
+// The demodulators' throughput is covered by the demod/fm benchmarks.
+static void CompareFixedPointAccuracy(BenchmarkSuite& suite)
+{
+    const unsigned int blocks = 40;
+    if (!suite.IsSelected("accuracy/fm"))
+    {
+        return;
+    }
+
+    // Two tones, noise, and a DC offset, quantized as the RTL-SDR would.
+    const float sampleRate = 2400000.0f;
+    const float deviation = 75000.0f;
+    SampleBlock<IqByte> rawSamples(samplesPerBlock * blocks);
+
+    std::mt19937 generator(42);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    double phase = 0.0;
+    for (std::size_t i = 0; i < rawSamples.size(); i++)
+    {
+        float time = (float)i / sampleRate;
+        float audio = 0.6f * std::sin(2 * Constants::PI * 1000.0f * time) + 0.3f * std::sin(2 * Constants::PI * 3100.0f * time);
+        phase += 2 * Constants::PI * deviation * audio / sampleRate;
+
+        float valueI = 0.7f * (float)std::cos(phase) + 0.01f + noise(generator);
+        float valueQ = 0.7f * (float)std::sin(phase) - 0.01f + noise(generator);
+        rawSamples[i].i = (unsigned char)std::max(0.0f, std::min(255.0f, std::floor(127.5f + valueI * 127.5f + 0.5f)));
+        rawSamples[i].q = (unsigned char)std::max(0.0f, std::min(255.0f, std::floor(127.5f + valueQ * 127.5f + 0.5f)));
+    }
+
+    Logger::Log("Fixed-point accuracy against floating-point, over ", blocks, " blocks of ", samplesPerBlock, " samples:");
+
+    // The filter and discriminator stages are compared on identical Q15 input, to isolate each stage's own error.
+    // The filter matches FMAudioTransformer's baseband stage, 2.4 MS/s to 400 kS/s.
+    SampleBlock<ComplexInt16> fixedPointInput = ConvertSamplesToInt16(rawSamples);
+    WindowedSincFilter basebandFilter;
+    basebandFilter.CreateFilter(100000.0f / 2400000.0f, 48);
+
+    SampleBlock<std::complex<float>> floatBaseband;
+    SampleBlock<ComplexInt16> fixedPointBaseband;
+    basebandFilter.Decimate(fixedPointInput.View(), 6, floatBaseband);
+    basebandFilter.DecimateFixedPoint(fixedPointInput.View(), 6, fixedPointBaseband);
+
+    ErrorStatistics filterError;
+    std::size_t basebandLength = std::min(floatBaseband.size(), fixedPointBaseband.size());
+    for (std::size_t i = 0; i < basebandLength; i++)
+    {
+        std::complex<float> value = SampleTraits<ComplexInt16>::ToComplexFloat(fixedPointBaseband[i]);
+        filterError.Add(floatBaseband[i].real(), value.real());
+        filterError.Add(floatBaseband[i].imag(), value.imag());
+    }
+
+    filterError.Log("FIR decimation");
+
+    ErrorStatistics discriminatorError;
+    for (std::size_t i = 1; i < basebandLength; i++)
+    {
+        ComplexInt16 sample = fixedPointBaseband[i];
+        ComplexInt16 lastSample = fixedPointBaseband[i - 1];
+        int real = (((int)sample.i * lastSample.i) >> 1) + (((int)sample.q * lastSample.q) >> 1);
+        int imag = (((int)sample.q * lastSample.i) >> 1) - (((int)sample.i * lastSample.q) >> 1);
+
+        float reference = std::atan2((float)imag, (float)real) / Constants::PI;
+        discriminatorError.Add(reference, (float)FixedPoint::Atan2(imag, real) / 32768.0f);
+    }
+
+    discriminatorError.Log("FM discriminator");
+
+    // Both complete demodulators, block-by-block as the audio stream would run them.
+    FMAudioTransformer floatTransformer;
+    FMAudioTransformer fixedPointTransformer;
+    fixedPointTransformer.SetPrecision(DspPrecision::FixedPoint);
+
+    std::vector<sf::Int16> floatAudio;
+    std::vector<sf::Int16> fixedPointAudio;
+    SampleBlock<std::complex<float>> floatSamples(samplesPerBlock);
+    IqConverter converter;
+    for (unsigned int block = 0; block < blocks; block++)
+    {
+        SampleView<const IqByte> blockSamples = rawSamples.Subview(block * samplesPerBlock, samplesPerBlock);
+        converter.Convert(blockSamples, floatSamples.View());
+        floatTransformer.Process(blockSamples, floatSamples.View(), &floatAudio);
+        fixedPointTransformer.Process(blockSamples, SampleView<const std::complex<float>>(), &fixedPointAudio);
+    }
+
+    ErrorStatistics audioError;
+    std::size_t audioLength = std::min(floatAudio.size(), fixedPointAudio.size());
+    for (std::size_t i = 0; i < audioLength; i += 2)
+    {
+        audioError.Add((float)floatAudio[i] / 32768.0f, (float)fixedPointAudio[i] / 32768.0f);
+    }
+
+    audioError.Log("FM audio");
+}
+
+// Benchmarks the DSP kernels. Usage: LuxBench [--filter name] [--repetitions n] [--min-time seconds] [--json path] [--label text]
+int main(int argc, char* argv[])
+{
+    Logger::Setup("lux-bench.log", true);
+
+    std::string filter;
+    unsigned int repetitions = 10;
+    float minRepetitionSeconds = 0.05f;
+    std::string jsonPath;
+    std::string label;
+    for (int i = 1; i < argc; i += 2)
+    {
+        std::string option(argv[i]);
+        if (i + 1 == argc)
+        {
+            Logger::LogError("Option '", option, "' requires a value.");
+            Logger::Shutdown();
+            return 1;
+        }
+
+        std::string value(argv[i + 1]);
+        if (option == "--filter")
+        {
+            filter = value;
+        }
+        else if (option == "--repetitions")
+        {
+            repetitions = (unsigned int)std::stoul(value);
+        }
+        else if (option == "--min-time")
+        {
+            minRepetitionSeconds = std::stof(value);
+        }
+        else if (option == "--json")
+        {
+            jsonPath = value;
+        }
+        else if (option == "--label")
+        {
+            label = value;
+        }
+        else
+        {
+            Logger::LogError("Unknown option '", option, "'.");
+            Logger::Shutdown();
+            return 1;
+        }
+    }
+
+    BenchmarkSuite suite(filter, repetitions, minRepetitionSeconds);
+    BenchmarkConversion(suite);
+    BenchmarkFft(suite);
+    BenchmarkLargeFft(suite);
+    BenchmarkStft(suite);
+    BenchmarkFir(suite);
+    BenchmarkDecimation(suite);
+    BenchmarkSpectrum(suite);
+    BenchmarkDemodulation(suite);
+    CompareFixedPointAccuracy(suite);
+
+    bool written = jsonPath.empty() || suite.WriteJson(jsonPath, label);
+    Logger::Shutdown();
+    return written ? 0 : 1;
+}
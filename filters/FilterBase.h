@@ -2,7 +2,12 @@
 #include <chrono>
 #include <future>
 #include <thread>
+#include "math\SampleBlock.h"
+#include "metrics\MetricsRegistry.h"
+#include "metrics\Tracer.h"
+#include "sdr\BlockMetadata.h"
 #include "sdr\SdrBuffer.h"
+#include "AsyncLogger.h"
 
 // Defines the base class for filter operations performed on I/Q SDR data
 class FilterBase
@@ -10,7 +15,85 @@ class FilterBase
     SdrBuffer* dataBuffer;
     unsigned int localBlockId;
 
-    std::vector<unsigned char> currentBlock;
+    // Blocks within this many of being overwritten are copied before processing, rather than read in place.
+    static const unsigned int lapMarginBlocks = 2;
+
+    // Copies of the block being processed, when it was close to being overwritten.
+    SampleBlock<std::complex<float>> blockCopy;
+    SampleBlock<IqByte> rawBlockCopy;
+    bool processingCopy;
+
+    // Tuning ID of the last block processed, to detect retunes.
+    unsigned int lastTuningId;
+
+    // Average time from when a block was captured to when this filter finished processing it.
+    std::atomic<float> averageLatency;
+
+    // Throughput statistics, over the life of the filter. Busy time is spent in Process and Accumulate.
+    Counter processedBlocks;
+    Counter droppedBlocks;
+    std::atomic<double> busySeconds;
+
+    // Distributions of the time from capture to the end of processing, and of the processing alone, per block.
+    LatencyHistogram latency;
+    LatencyHistogram processingTime;
+
+    // Name the metrics are registered under, once the filter is first enabled, as GetName can't be called before then.
+    std::string metricsName;
+
+    void RegisterMetrics()
+    {
+        metricsName = GetName();
+        MetricsRegistry::Register(metricsName + ".processed_blocks", &processedBlocks);
+        MetricsRegistry::Register(metricsName + ".dropped_blocks", &droppedBlocks);
+        MetricsRegistry::Register(metricsName + ".latency", &latency);
+        MetricsRegistry::Register(metricsName + ".processing_time", &processingTime);
+    }
+
+    void UnregisterMetrics()
+    {
+        MetricsRegistry::Unregister(metricsName + ".processed_blocks", &processedBlocks);
+        MetricsRegistry::Unregister(metricsName + ".dropped_blocks", &droppedBlocks);
+        MetricsRegistry::Unregister(metricsName + ".latency", &latency);
+        MetricsRegistry::Unregister(metricsName + ".processing_time", &processingTime);
+    }
+
+    // False while nothing shows this filter's results, such as when its pane is off-screen.
+    std::atomic<bool> presented;
+
+    // Most times per second the results are worth presenting, or 0 to process every block in full.
+    std::atomic<float> displayRate;
+    std::chrono::steady_clock::time_point lastPresentation;
+
+    // Blocks between presentations only feed the filter's state, skipping the work to present them.
+    bool IsPresentationDue()
+    {
+        if (!presented)
+        {
+            return false;
+        }
+
+        float rate = displayRate;
+        if (rate <= 0.0f)
+        {
+            return true;
+        }
+
+        // If the last results haven't been shown yet, new ones would be dropped unseen.
+        if (HasUnpresentedResults())
+        {
+            return false;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - lastPresentation < std::chrono::duration<float>(1.0f / rate))
+        {
+            return false;
+        }
+
+        lastPresentation = now;
+        return true;
+    }
 
     bool acquiringBlocks;
     std::future<void> acquisitionThread;
@@ -18,28 +101,106 @@ class FilterBase
     // Continually acquire blocks, sending them to the associated process function in a mirrored data set.
     void AcquireBlocks()
     {
-        bool wasEnabled = true;
+        // Starts out paused, as the derived filter may still be under construction, so GetName can't be called yet.
+        bool wasEnabled = false;
         while (acquiringBlocks)
         {
-            if (enabled)
+            // Unseen filters with no state to keep are paused outright. Either way, they resume from the current block.
+            if (enabled && (presented || KeepsRunningWhenHidden()))
             {
                 if (!wasEnabled)
                 {
+                    if (metricsName.empty())
+                    {
+                        RegisterMetrics();
+                        TRACE_THREAD_NAME(metricsName);
+                    }
+
                     localBlockId = dataBuffer->GetCurrentBlockId();
                     wasEnabled = true;
                 }
 
+                bool skippedBlocks = false;
                 while (acquiringBlocks && localBlockId != dataBuffer->GetCurrentBlockId())
                 {
-                    // Acquire and process the new block.
-                    int idx = (localBlockId % dataBuffer->GetReadBlocks());
-                    int startOffset = idx * dataBuffer->GetReadSize();
-                    int endOffset = (idx + 1) * dataBuffer->GetReadSize();
-                    currentBlock.clear();
-                    currentBlock.insert(currentBlock.begin(), dataBuffer->GetBuffer().begin() + startOffset, dataBuffer->GetBuffer().begin() + endOffset);
+                    TRACE_SCOPE("FilterBase::AcquireBlocks");
+
+                    // If we have fallen an entire buffer behind, the blocks we haven't read are gone. Skip to the oldest valid block.
+                    unsigned int currentBlockId = dataBuffer->GetCurrentBlockId();
+                    if (currentBlockId - localBlockId >= dataBuffer->GetReadBlocks())
+                    {
+                        unsigned int oldestBlockId = currentBlockId - (dataBuffer->GetReadBlocks() - 1);
+                        droppedBlocks.Increment(oldestBlockId - localBlockId);
+                        localBlockId = oldestBlockId;
+                        skippedBlocks = true;
+                    }
+
+                    // Acquire and process the new block. The samples are used in place unless the block is about to be overwritten.
+                    BlockMetadata metadata = dataBuffer->GetBlockMetadata(localBlockId);
+                    SampleView<const std::complex<float>> samples = dataBuffer->GetBlockSamples(localBlockId);
+
+                    // The acquisition thread may have lapped us since we checked, in which case the block is from a later pass.
+                    // The skip at the top of the loop counts it as dropped.
+                    if (metadata.sequence != localBlockId)
+                    {
+                        skippedBlocks = true;
+                        continue;
+                    }
+
+                    // Close to being lapped, the block could be rewritten while the filter reads it. Work from a copy instead.
+                    processingCopy = dataBuffer->GetCurrentBlockId() - localBlockId >= dataBuffer->GetReadBlocks() - lapMarginBlocks;
+                    if (processingCopy)
+                    {
+                        blockCopy.Assign(samples);
+                        rawBlockCopy.Assign(dataBuffer->GetBlockRawSamples(localBlockId));
+                        samples = blockCopy.View();
+
+                        // If the block was overwritten while copying, the copy is torn. Drop it as above.
+                        if (dataBuffer->GetCurrentBlockId() - localBlockId >= dataBuffer->GetReadBlocks())
+                        {
+                            skippedBlocks = true;
+                            continue;
+                        }
+                    }
+
+                    metadata.droppedSamples = metadata.droppedSamples || skippedBlocks;
+                    skippedBlocks = false;
+
+                    if (metadata.tuningId != lastTuningId)
+                    {
+                        lastTuningId = metadata.tuningId;
+                        this->OnTuningChanged(metadata);
+                    }
                     
                     // Logger::Log("Filter '", GetName(), "' processing new block ID ", (int)localBlockId, ".");
-                    this->Process(&currentBlock);
+                    std::chrono::steady_clock::time_point processingStart = std::chrono::steady_clock::now();
+                    if (IsPresentationDue())
+                    {
+                        this->Process(samples, metadata);
+                    }
+                    else
+                    {
+                        this->Accumulate(samples, metadata);
+                    }
+
+                    // In place, a filter slower than the whole buffer can still be lapped mid-block. Its results are from torn samples.
+                    if (!processingCopy && dataBuffer->GetCurrentBlockId() - localBlockId >= dataBuffer->GetReadBlocks())
+                    {
+                        ASYNC_LOG_WARN("Filter '", metricsName, "' took so long that block ", localBlockId, " was overwritten while processing it.");
+                        droppedBlocks.Increment();
+                    }
+                    else
+                    {
+                        processedBlocks.Increment();
+                    }
+
+                    std::chrono::steady_clock::time_point processingEnd = std::chrono::steady_clock::now();
+                    busySeconds = busySeconds + std::chrono::duration<double>(processingEnd - processingStart).count();
+                    processingTime.Record(processingEnd - processingStart);
+                    latency.Record(processingEnd - metadata.captureTime);
+
+                    std::chrono::duration<float> blockLatency = processingEnd - metadata.captureTime;
+                    averageLatency = averageLatency * 0.9f + blockLatency.count() * 0.1f;
                     
                     ++localBlockId;
                 }
@@ -56,9 +217,13 @@ class FilterBase
             }
             else
             {
-                wasEnabled = false;
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                Logger::Log("Sleeing for 500 ms as the '", GetName(), "' filter was disabled.");
+                if (wasEnabled)
+                {
+                    Logger::Log("Pausing the '", GetName(), "' filter while it is disabled or hidden.");
+                    wasEnabled = false;
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
             }
         }
     }
@@ -66,6 +231,32 @@ class FilterBase
 protected:
     bool enabled;
 
+    // Returns the unconverted bytes of the block being processed, for filters that don't work in floating-point.
+    SampleView<const IqByte> GetRawSamples(const BlockMetadata& metadata) const
+    {
+        return processingCopy ? rawBlockCopy.View() : dataBuffer->GetBlockRawSamples(metadata.sequence);
+    }
+
+    // Limits full processing to at most this many blocks per second, plus only once the last results have been presented.
+    // Other blocks go to Accumulate. Visualization filters set this, as results nobody sees are wasted work.
+    void SetDisplayRate(float updatesPerSecond)
+    {
+        displayRate = updatesPerSecond;
+    }
+
+    // Returns true if Accumulate has work that matters even while the results aren't shown, such as detection.
+    // Otherwise the filter is paused entirely while hidden.
+    virtual bool KeepsRunningWhenHidden()
+    {
+        return false;
+    }
+
+    // Returns true while results from the last Process call are still waiting to be shown.
+    virtual bool HasUnpresentedResults()
+    {
+        return false;
+    }
+
     void StopFilter()
     {
         if (acquiringBlocks)
@@ -73,14 +264,19 @@ protected:
             acquiringBlocks = false;
             acquisitionThread.wait();
         }
+
+        if (!metricsName.empty())
+        {
+            UnregisterMetrics();
+            metricsName.clear();
+        }
     }
 
 public:
     FilterBase(SdrBuffer* dataBuffer)
-        : dataBuffer(dataBuffer), acquiringBlocks(true)
+        : dataBuffer(dataBuffer), blockCopy(), rawBlockCopy(), processingCopy(false), lastTuningId(0), averageLatency(0.0f), processedBlocks(), droppedBlocks(), busySeconds(0.0), latency(), processingTime(), metricsName(), presented(true), displayRate(0.0f), lastPresentation(), acquiringBlocks(true)
     {
         localBlockId = dataBuffer->GetCurrentBlockId();
-        currentBlock.reserve(dataBuffer->GetReadSize());
 
         enabled = false;
         acquisitionThread = std::async(std::launch::async, &FilterBase::AcquireBlocks, this);
@@ -88,11 +284,53 @@ public:
 
     virtual std::string GetName() const = 0;
 
-    // Performs filter-specific short-term processing. Called for every new block.
+    // Sets whether anything shows this filter's results. While not presented, Process isn't called.
+    void SetPresented(bool isPresented)
+    {
+        presented = isPresented;
+    }
+
+    // Returns the average time, in seconds, from block capture to the end of processing in this filter.
+    float GetAverageLatency() const
+    {
+        return averageLatency;
+    }
+
+    // Returns how many blocks were processed (or accumulated), and how many were overwritten before this filter got to them.
+    unsigned long long GetProcessedBlocks() const
+    {
+        return processedBlocks.Get();
+    }
+
+    unsigned long long GetDroppedBlocks() const
+    {
+        return droppedBlocks.Get();
+    }
+
+    // Returns the total time, in seconds, spent processing blocks. Against the elapsed time, this is how loaded the filter's thread is.
+    double GetBusySeconds() const
+    {
+        return busySeconds;
+    }
+
+    // Called before processing the first block acquired with a new center frequency, gain, or sample rate.
+    // Filters that carry state across blocks should reset it here, as it no longer applies to incoming data.
+    virtual void OnTuningChanged(const BlockMetadata& metadata)
+    {
+    }
+
+    // Performs filter-specific short-term processing. Called for every new block, with samples normalized to [-1, 1].
     // Processes that need several blocks, or are expected to acquire blocks and then
     //  perform extensive processing them (discarding or caching new blocks during the extensive processing),
     //  should use a dedicated thread to perform said processing.
-    virtual void Process(std::vector<unsigned char>* block) = 0;
+    // The samples are only valid for the duration of the call.
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) = 0;
+
+    // Called instead of Process for blocks that arrive between presentations, when a display rate is set.
+    // Filters with state that must see every block, such as averages, should update it here. Others can skip the block.
+    virtual void Accumulate(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+    {
+    }
 
     virtual ~FilterBase()
     {
@@ -1,12 +1,16 @@
 #include <algorithm>
-#include <chrono>
-#include <limits>
-#include "FrequencySpectrum.h"
+#include <sstream>
 #include "math\FourierTransform.h"
+#include "FrequencySpectrum.h"
 
 FrequencySpectrum::FrequencySpectrum(glm::vec2 startPosition, glm::vec2 startSize, SdrBuffer* dataBuffer)
-    : lastPosition(startPosition), lastSize(startSize), updateGraphics(false), fftReals(), fftImags(), FilterBase(dataBuffer)
+    : lastPosition(startPosition), lastSize(startSize), snapshots(), powerSpectrum(fftSize, SpectrumWindow::Blackman, 0.5f),
+      power(), powerDb(), detector(CfarMethod::OrderedStatistic, 16, 2, 1e-6f), occupancyStore(nullptr), spectrumLines(true, 8192, PlotVertexFormat::ImplicitX), displayLevels(), visibleStart(0.0f), visibleStop(1.0f), pixelWidth(0), rangeChanged(false), titleChanged(false),
+      sampleRate(2400000), zoomReals(), zoomImags(), zoomPower(), zoomPowerDb(), FilterBase(dataBuffer)
 {
+    powerSpectrum.SetAveraging(SpectrumAveraging::Exponential, 0.01f);
+    spectrumLines.SetSeriesColor(glm::vec3(1.0f, 1.0f, 0.0f));
+    SetDisplayRate(maxDisplayRate);
     enabled = true;
 }
 
@@ -15,117 +19,163 @@ std::string FrequencySpectrum::GetName() const
     return "Frequency Spectrum";
 }
 
-void FrequencySpectrum::Process(std::vector<unsigned char>* block)
+void FrequencySpectrum::OnTuningChanged(const BlockMetadata& metadata)
 {
-    // Logger::Log("Processing block of ", block->size(), " elements in filter '", GetName(), "'.");
-
-    // Displays the IQ spectrum flattened on the XY plane.
-    unsigned int fftSize = 1024 * 2;
-    std::vector<unsigned char> fftBuffer;
-    fftBuffer.reserve(fftSize); // 2 ^ 14. or 2.3 kHz Hz per frequency window.
+    // The averaged spectrum is of the previous frequency range.
+    powerSpectrum.Reset();
+}
 
-    // Just copy the first few samples with some very inaccurate decimation. TODO make an actual flow structure for processed data.
-    unsigned int downscaleAmount = 1; // 8; FYI this leads to jitter as we're not properly decimating. It does provide a minimum amount of zoom though.
-    for (unsigned int i = 0, j = 0; j < fftSize / 2; j++, i+= downscaleAmount)
+void FrequencySpectrum::ComputeZoomedSpectrum(SampleView<const std::complex<float>> block, float start, float stop)
+{
+    // The display runs from -0.5 to 0.5 of the sample rate. Compute one bin per pixel.
+    unsigned int bins = (unsigned int)std::max(pixelWidth.load(), 16);
+    float centerFrequency = (start + stop) / 2.0f - 0.5f;
+    if (!FourierTransform::ZoomSpectrum(block, centerFrequency, stop - start, bins, zoomReals, zoomImags))
     {
-        fftBuffer.push_back((*block)[i * 2]);
-        fftBuffer.push_back((*block)[i * 2 + 1]);
+        return;
     }
-    
-    std::vector<float> reals;
-    std::vector<float> imags;
-    auto startTime = std::chrono::high_resolution_clock::now();
-    // FourierTransform::ComplexDFT(fftBuffer, reals, imags);
-    FourierTransform::ComplexDFT(fftBuffer, reals, imags);
-    auto stopTime = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<float> time = (stopTime - startTime);
-    Logger::Log("Performed a fourier transform of ", fftSize / 2, " complex elements in ", time.count(), " sec.");
-
-    float minReal = std::numeric_limits<float>::max();
-    float maxReal = std::numeric_limits<float>::min();
-    float avgReal = 0;
-    float minImag = std::numeric_limits<float>::max();
-    float maxImag = std::numeric_limits<float>::min();
-    float avgImag = 0;
-    for (unsigned int i = 0; i < reals.size(); i++)
+
+    bool reseed = zoomPower.size() != bins;
+    zoomPower.resize(bins);
+    for (unsigned int i = 0; i < bins; i++)
     {
-        if (reals[i] < minReal)
-        {
-            minReal = reals[i];
-        }
+        float power = zoomReals[i] * zoomReals[i] + zoomImags[i] * zoomImags[i];
+        zoomPower[i] = reseed ? power : zoomPower[i] + zoomAveragingFactor * (power - zoomPower[i]);
+    }
 
-        if (reals[i] > maxReal)
-        {
-            maxReal = reals[i];
-        }
+    zoomPowerDb.resize(bins);
+    PowerSpectrum::ToDecibels(zoomPower.data(), zoomPowerDb.data(), bins);
+}
 
-        avgReal += reals[i];
+void FrequencySpectrum::AnalyzeFullBand(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    powerSpectrum.AddSamples(block);
+    powerSpectrum.GetPower(power);
 
-        if (imags[i] < minImag)
-        {
-            minImag = imags[i];
-        }
+    double binWidth = (double)metadata.sampleRate / (double)fftSize;
+    double lowestFrequency = (double)metadata.centerFrequency - (double)metadata.sampleRate / 2.0;
+    detector.Detect(power, lowestFrequency, binWidth, metadata.captureTime);
 
-        if (imags[i] > maxImag)
-        {
-            maxImag = imags[i];
-        }
+    powerDb.resize(power.size());
+    PowerSpectrum::ToDecibels(power.data(), powerDb.data(), power.size());
 
-        avgImag += imags[i];
+    SpectrumOccupancyStore* store = occupancyStore;
+    if (store != nullptr && powerSpectrum.GetSegmentCount() != 0)
+    {
+        store->Ingest(powerDb, metadata.centerFrequency, metadata.sampleRate, metadata.captureTime);
     }
+}
 
-    avgReal /= reals.size();
-    avgImag /= imags.size();
-    Logger::Log("Min, Max -- Re: [", minReal, ", ", maxReal, "], Im: [", minImag, ", ", maxImag, "]");
-    avgReal = (avgReal - minReal) / (maxReal - minReal);
-    avgImag = (avgImag - minImag) / (maxImag - minImag);
+void FrequencySpectrum::ResetIfRangeChanged()
+{
+    // The zoomed average is of the previous span. The full-band average doesn't depend on what's visible.
+    if (rangeChanged.exchange(false))
+    {
+        zoomPower.clear();
+    }
+}
 
-    float upscaleFactor = 4.0f;
+void FrequencySpectrum::Accumulate(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("FrequencySpectrum::Accumulate");
+    sampleRate = metadata.sampleRate;
+    ResetIfRangeChanged();
 
-    graphicsUpdateLock.lock();
-    fftReals.Clear();
-    fftImags.Clear();
+    // Blocks between presentations still feed the detector and the occupancy store. Only the zoomed view, which is just displayed, skips them.
+    AnalyzeFullBand(block, metadata);
+}
 
-    for (unsigned int i = 0; i < reals.size(); i++)
-    {
-        float xPosition = lastPosition.x + ((float)i / (float)reals.size()) * lastSize.x;
-        float percentReal = (reals[i] - minReal) / (maxReal - minReal);
-        float yPositionReal = lastPosition.y + percentReal * lastSize.y * upscaleFactor;
+void FrequencySpectrum::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("FrequencySpectrum::Process");
+    sampleRate = metadata.sampleRate;
+    ResetIfRangeChanged();
 
-        float percentImag = (imags[i] - minImag) / (maxImag - minImag);
-        float yPositionImag = lastPosition.y + percentImag * lastSize.y * upscaleFactor;
+    // Detection runs on the full band whatever is shown. The zoomed spectrum is computed in addition, only for display.
+    AnalyzeFullBand(block, metadata);
 
-        fftReals.positionBuffer.vertices.push_back(glm::vec3(xPosition, yPositionReal, 0.0f));
-        fftReals.colorBuffer.vertices.push_back(glm::vec3(1.0f, 1.0f, 0.0f));
+    float start = visibleStart;
+    float stop = visibleStop;
+    bool zoomed = stop - start < 1.0f;
+    if (zoomed)
+    {
+        ComputeZoomedSpectrum(block, start, stop);
+    }
 
-        fftImags.positionBuffer.vertices.push_back(glm::vec3(xPosition, yPositionImag, 0.0f));
-        fftImags.colorBuffer.vertices.push_back(glm::vec3(1.0f, 0.0f, 1.0f));
+    const std::vector<float>& displayedDb = zoomed ? zoomPowerDb : powerDb;
+    displayLevels.clear();
+    for (unsigned int i = 0; i < displayedDb.size(); i++)
+    {
+        float percentPower = (displayedDb[i] - minDisplayPower) / (maxDisplayPower - minDisplayPower);
+        displayLevels.push_back(lastPosition.y + std::min(std::max(percentPower, 0.0f), 1.0f) * lastSize.y);
     }
 
-    graphicsUpdateLock.unlock();
-    updateGraphics = true;
+    SeriesSnapshot& snapshot = snapshots.GetWriteBuffer();
+    PlotDecimator::MinMaxEnvelope(displayLevels, (unsigned int)std::max(pixelWidth.load(), 0), snapshot.values);
+    snapshot.xOrigin = lastPosition.x;
+    snapshot.xStep = lastSize.x / (float)std::max(snapshot.values.size(), (std::size_t)1);
+    snapshots.Publish();
+}
+
+bool FrequencySpectrum::HasUnpresentedResults()
+{
+    return snapshots.HasUnread();
+}
+
+bool FrequencySpectrum::KeepsRunningWhenHidden()
+{
+    // Detection and the occupancy store don't depend on the plot being seen.
+    return true;
+}
+
+CfarDetector& FrequencySpectrum::GetDetector()
+{
+    return detector;
+}
+
+void FrequencySpectrum::SetOccupancyStore(SpectrumOccupancyStore* store)
+{
+    occupancyStore = store;
 }
 
 bool FrequencySpectrum::HasTitleUpdate()
 {
-    return false;
+    return titleChanged;
 }
 
 std::string FrequencySpectrum::GetTitle()
 {
-    return "Frequency Spectrum";
+    titleChanged = false;
+
+    std::stringstream title;
+    title << "Power Spectrum";
+    float span = visibleStop - visibleStart;
+    if (span < 1.0f)
+    {
+        title << ", " << span * (float)sampleRate / 1000.0f << " kHz span";
+    }
+
+    title << " (dBFS)";
+    return title.str();
+}
+
+void FrequencySpectrum::SetVisibleRange(float start, float stop, int pixelWidth)
+{
+    this->pixelWidth = pixelWidth;
+    if (start != visibleStart || stop != visibleStop)
+    {
+        visibleStart = start;
+        visibleStop = stop;
+        rangeChanged = true;
+        titleChanged = true;
+    }
 }
 
 void FrequencySpectrum::Update(float elapsedTime, float frameTime)
 {
-    if (updateGraphics)
+    if (snapshots.Acquire())
     {
-        graphicsUpdateLock.lock();
-        fftReals.Update();
-        fftImags.Update();
-        graphicsUpdateLock.unlock();
-        
-        updateGraphics = false;
+        spectrumLines.Update(snapshots.GetReadBuffer());
     }
 }
 
@@ -134,8 +184,12 @@ void FrequencySpectrum::Render(glm::mat4 & projectionMatrix, glm::vec2 position,
     lastPosition = position;
     lastSize = size;
 
-    fftReals.Render(projectionMatrix);
-    fftImags.Render(projectionMatrix);
+    spectrumLines.Render(projectionMatrix);
+}
+
+void FrequencySpectrum::SetVisible(bool visible)
+{
+    SetPresented(visible);
 }
 
 FrequencySpectrum::~FrequencySpectrum()
@@ -1,20 +1,70 @@
 #pragma once
+#include <atomic>
+#include <vector>
 #include "FilterBase.h"
 #include "GuCommon\shaders\ShaderFactory.h"
-#include "math\WindowedSincFilter.h"
+#include "math\CfarDetector.h"
+#include "math\PlotDecimator.h"
+#include "math\PowerSpectrum.h"
+#include "SpectrumOccupancyStore.h"
 #include "IPaneRenderable.h"
-#include "PointRenderer.h"
+#include "TripleBuffer.h"
 #include "LineRenderer.h"
 
+// Displays the averaged power spectral density of the incoming samples.
 class FrequencySpectrum : public FilterBase, public IPaneRenderable
 {
-    PointRenderer fftReals;
-    PointRenderer fftImags;
+    // 2.3 kHz per bin at 2.4 MS/s.
+    const unsigned int fftSize = 1024;
+
+    // Fixed display range, so the plot doesn't jump around as the signal changes.
+    const float minDisplayPower = -100.0f;
+    const float maxDisplayPower = 0.0f;
+
+    // The plot is rebuilt at most this often, plus only once the last one was drawn.
+    const float maxDisplayRate = 30.0f;
+
+    // How quickly the zoomed spectrum follows each new block.
+    const float zoomAveragingFactor = 0.3f;
+
+    PowerSpectrum powerSpectrum;
+    std::vector<float> power;
+    std::vector<float> powerDb;
+
+    // Detects signals in the full-band spectrum. Zoomed spectra aren't searched.
+    CfarDetector detector;
+
+    // Records each full-band spectrum, if set, whatever part of the band is visible.
+    std::atomic<SpectrumOccupancyStore*> occupancyStore;
+    LineRenderer spectrumLines;
+
+    // Plot heights of every bin, reduced to a min/max envelope when there are more bins than pixels.
+    std::vector<float> displayLevels;
+
+    // The visible part of the band, set by the pane. When zoomed in, only the visible span is computed, at the pane's resolution.
+    std::atomic<float> visibleStart;
+    std::atomic<float> visibleStop;
+    std::atomic<int> pixelWidth;
+    std::atomic<bool> rangeChanged;
+    std::atomic<bool> titleChanged;
+    std::atomic<unsigned int> sampleRate;
+
+    std::vector<float> zoomReals;
+    std::vector<float> zoomImags;
+    std::vector<float> zoomPower;
+    std::vector<float> zoomPowerDb;
+    void ComputeZoomedSpectrum(SampleView<const std::complex<float>> block, float start, float stop);
+
+    // Averages, detects and records the full band. Runs for every block, presented or not, whatever the zoom.
+    void AnalyzeFullBand(SampleView<const std::complex<float>> block, const BlockMetadata& metadata);
+    // Restarts the zoomed average when the visible range changes.
+    void ResetIfRangeChanged();
 
     glm::vec2 lastPosition;
     glm::vec2 lastSize;
-    bool updateGraphics;
-    std::mutex graphicsUpdateLock;
+
+    // Each processed spectrum's vertices, handed to the render thread without either side blocking.
+    TripleBuffer<SeriesSnapshot> snapshots;
 
 public:
     FrequencySpectrum(glm::vec2 startPosition, glm::vec2 startSize, SdrBuffer* dataBuffer);
@@ -22,12 +72,23 @@ public:
 
     // Inherited via FilterBase
     virtual std::string GetName() const override;
-    virtual void Process(std::vector<unsigned char>* block) override;
+    virtual void OnTuningChanged(const BlockMetadata& metadata) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+    virtual void Accumulate(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+    virtual bool HasUnpresentedResults() override;
+    virtual bool KeepsRunningWhenHidden() override;
+
+    // Queues the signals found in each full-band spectrum.
+    CfarDetector& GetDetector();
+
+    // Starts recording full-band spectra into the store. The store must outlive this filter.
+    void SetOccupancyStore(SpectrumOccupancyStore* store);
 
     // Inherited via IPaneRenderable
     virtual bool HasTitleUpdate() override;
     virtual std::string GetTitle() override;
     virtual void Update(float elapsedTime, float frameTime) override;
     virtual void Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size) override;
+    virtual void SetVisibleRange(float start, float stop, int pixelWidth) override;
+    virtual void SetVisible(bool visible) override;
 };
-
@@ -1,12 +1,17 @@
 #include <algorithm>
+#include <cmath>
+#include "AsyncLogger.h"
 #include "IQSpectrum.h"
 
 IQSpectrum::IQSpectrum(glm::vec2 startPosition, glm::vec2 startSize, SdrBuffer* dataBuffer)
     : lastPosition(startPosition), lastSize(startSize),
-      updateGraphics(false), iqPoints(),
+      displayMode(IqDisplayMode::Density), iqPoints(16384, PlotVertexFormat::Position2d),
+      densityMap(densityCells, densityCells), density((std::size_t)densityCells * densityCells, 0.0f), densitySnapshots(), pointSnapshots(), pixelThinning(), pixelWidth(0),
       windowedSincFilter(), FilterBase(dataBuffer)
 {
     FormDecimator();
+    iqPoints.SetSeriesColor(glm::vec3(0.50f, 0.50f, 1.0f));
+    SetDisplayRate(maxDisplayRate);
     enabled = true;
 }
 
@@ -32,44 +37,112 @@ std::string IQSpectrum::GetName() const
     return "IQ Spectrum";
 }
 
-void IQSpectrum::Process(std::vector<unsigned char>* block)
+void IQSpectrum::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
 {
+    TRACE_SCOPE("IQSpectrum::Process");
     // Logger::Log("Processing block of ", block->size(), " elements in filter '", GetName(), "'.");
 
     // Displays the IQ spectrum flattened on the XY plane.
-    float scale = (1.0f / 127.5f) * std::min(lastSize.x, lastSize.y);
+    float scale = std::min(lastSize.x, lastSize.y);
 
-    graphicsUpdateLock.lock();
-    iqPoints.Clear();
-    Logger::Log("Size block:", block->size(), " decimator:", windowedSincFilter.kernel.size(), ".");
-    int samples = block->size() / 2;
-    for (unsigned int n = 0; n < samples - windowedSincFilter.kernel.size(); n += windowedSincFilter.kernel.size()) // n < block->size() / 2; n++)
+    // TODO determine how to properly decimate IQ signals.
+    // TODO this leads to discontinuities at edges. We should grab two buffers and process that to avoid boundary problems.
+    // TODO there are weird artefacts using these decimation factors (scaling & descaling).
+    windowedSincFilter.Decimate(block, windowedSincFilter.kernel.size(), decimatedSamples);
+    if (displayMode == IqDisplayMode::Density)
     {
-        // TODO determine how to properly decimate IQ signals.
-        // TODO this leads to discontinuities at edges. We should grab two buffers and process that to avoid boundary problems.
-        float i = 0;
-        float q = 0;
-        for (unsigned int m = 0; m < windowedSincFilter.kernel.size(); m++)
-        {
-            // TODO there are weird artefacts using these decimation factors (scaling & descaling).s
-            i += ((float)(*block)[(n + m) * 2] - 127.5f) * scale * windowedSincFilter.kernel[m];
-            q += ((float)(*block)[(n + m) * 2 + 1] - 127.5f) * scale * windowedSincFilter.kernel[m];
-        }
+        AccumulateDensity(scale);
+        PublishDensity();
+        return;
+    }
+
+    int columns = std::max(pixelWidth.load(), 0);
+    int rows = lastSize.x > 0.0f ? (int)((float)columns * lastSize.y / lastSize.x) : 0;
+    pixelThinning.ResetPixels(rows > 0 ? columns : 0, std::max(rows, 0));
+
+    std::vector<glm::vec2>& points = pointSnapshots.GetWriteBuffer().points;
+    points.clear();
+    ASYNC_LOG("Size block:", block.size(), " decimator:", windowedSincFilter.kernel.size(), ".");
+    for (unsigned int n = 0; n < decimatedSamples.size(); n++)
+    {
+        float i = decimatedSamples[n].real() * scale;
+        float q = decimatedSamples[n].imag() * scale;
         
         i = std::max(i, -lastSize.x / 2.0f);
         i = std::min(i, lastSize.x / 2.0f);
         q = std::max(q, -lastSize.y / 2.0f);
         q = std::min(q, lastSize.y / 2.0f);
 
-        // i = ((float)(*block)[n * 2] - 127.5f) * scale;
-        // q = ((float)(*block)[n * 2 + 1] - 127.5f) * scale;
-        
-        iqPoints.positionBuffer.vertices.push_back(glm::vec3(lastPosition.x + i, lastPosition.y + q, 0.0f) + glm::vec3(lastSize.x / 2.0f, lastSize.y / 2.0f, 0.0f));
-        iqPoints.colorBuffer.vertices.push_back(glm::vec3(0.50f, 0.50f, 1.0f));
+        if (!pixelThinning.ClaimPixel(i / lastSize.x + 0.5f, q / lastSize.y + 0.5f))
+        {
+            continue;
+        }
+
+        points.push_back(glm::vec2(lastPosition.x + i, lastPosition.y + q) + lastSize / 2.0f);
+    }
+
+    pointSnapshots.Publish();
+}
+
+void IQSpectrum::AccumulateDensity(float scale)
+{
+    for (float& count : density)
+    {
+        count *= densityDecay;
+    }
+
+    // Cells cover the same extent as the points would, clamping at the edges in the same way.
+    for (unsigned int n = 0; n < decimatedSamples.size(); n++)
+    {
+        float x = decimatedSamples[n].real() * scale / lastSize.x + 0.5f;
+        float y = decimatedSamples[n].imag() * scale / lastSize.y + 0.5f;
+
+        unsigned int column = (unsigned int)std::min(std::max(x, 0.0f) * densityCells, (float)(densityCells - 1));
+        unsigned int row = (unsigned int)std::min(std::max(y, 0.0f) * densityCells, (float)(densityCells - 1));
+        density[(std::size_t)row * densityCells + column] += 1.0f;
+    }
+}
+
+void IQSpectrum::PublishDensity()
+{
+    float peak = *std::max_element(density.begin(), density.end());
+    float levelScale = peak > 0.0f ? 255.0f / std::log1p(peak) : 0.0f;
+
+    // Log scaling keeps sparse outliers visible next to a dense center.
+    std::vector<unsigned char>& levels = densitySnapshots.GetWriteBuffer();
+    levels.resize(density.size());
+    for (std::size_t i = 0; i < density.size(); i++)
+    {
+        levels[i] = (unsigned char)(std::log1p(density[i]) * levelScale);
     }
 
-    graphicsUpdateLock.unlock();
-    updateGraphics = true;
+    densitySnapshots.Publish();
+}
+
+void IQSpectrum::Accumulate(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("IQSpectrum::Accumulate");
+    // The density histogram decays per block, so it must see every block. Points are only drawn from the latest.
+    if (displayMode == IqDisplayMode::Density)
+    {
+        windowedSincFilter.Decimate(block, windowedSincFilter.kernel.size(), decimatedSamples);
+        AccumulateDensity(std::min(lastSize.x, lastSize.y));
+    }
+}
+
+bool IQSpectrum::HasUnpresentedResults()
+{
+    return displayMode == IqDisplayMode::Density ? densitySnapshots.HasUnread() : pointSnapshots.HasUnread();
+}
+
+IqDisplayMode IQSpectrum::GetDisplayMode() const
+{
+    return displayMode;
+}
+
+void IQSpectrum::SetDisplayMode(IqDisplayMode mode)
+{
+    displayMode = mode;
 }
 
 bool IQSpectrum::HasTitleUpdate()
@@ -84,13 +157,14 @@ std::string IQSpectrum::GetTitle()
 
 void IQSpectrum::Update(float elapsedTime, float frameTime)
 {
-    if (updateGraphics)
+    if (densitySnapshots.Acquire())
     {
-        graphicsUpdateLock.lock();
-        iqPoints.Update();
-        graphicsUpdateLock.unlock();
+        densityMap.SetDensity(densitySnapshots.GetReadBuffer().data());
+    }
 
-        updateGraphics = false;
+    if (pointSnapshots.Acquire())
+    {
+        iqPoints.Update(pointSnapshots.GetReadBuffer());
     }
 }
 
@@ -99,7 +173,24 @@ void IQSpectrum::Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::v
     lastPosition = position;
     lastSize = size;
 
-    iqPoints.Render(projectionMatrix);
+    if (displayMode == IqDisplayMode::Density)
+    {
+        densityMap.Render(projectionMatrix, position, size);
+    }
+    else
+    {
+        iqPoints.Render(projectionMatrix);
+    }
+}
+
+void IQSpectrum::SetVisibleRange(float start, float stop, int pixelWidth)
+{
+    this->pixelWidth = pixelWidth;
+}
+
+void IQSpectrum::SetVisible(bool visible)
+{
+    SetPresented(visible);
 }
 
 IQSpectrum::~IQSpectrum()
@@ -1,23 +1,61 @@
 #pragma once
+#include <atomic>
 #include <string>
+#include <vector>
 #include <GL/glew.h>
 #include "FilterBase.h"
 #include "GuCommon\vertex\PositionVbo.hpp"
 #include "GuCommon\vertex\ColorVbo.hpp"
+#include "math\PlotDecimator.h"
 #include "math\WindowedSincFilter.h"
 #include "IPaneRenderable.h"
+#include "TripleBuffer.h"
+#include "DensityRenderer.h"
 #include "PointRenderer.h"
 
+// How the IQ samples are shown.
+enum class IqDisplayMode
+{
+    // Each sample is a point.
+    Points,
+
+    // Samples are accumulated into a decaying 2D histogram, drawn as a heatmap.
+    Density
+};
+
 class IQSpectrum : public FilterBase, public IPaneRenderable
 {
+    // Cells along each side of the density histogram.
+    const unsigned int densityCells = 128;
+
+    // Each block, the histogram keeps this fraction of its previous counts, so it follows the recent distribution.
+    const float densityDecay = 0.9f;
+
+    std::atomic<IqDisplayMode> displayMode;
     PointRenderer iqPoints;
+    DensityRenderer densityMap;
+
+    // Decaying sample counts of each cell. Their log-scaled levels are published for upload.
+    std::vector<float> density;
+    TripleBuffer<std::vector<unsigned char>> densitySnapshots;
+
+    // Each processed block's points, handed to the render thread without either side blocking.
+    TripleBuffer<SeriesSnapshot> pointSnapshots;
+    void AccumulateDensity(float scale);
+    void PublishDensity();
+
+    // The plot is rebuilt at most this often, plus only once the last one was drawn.
+    const float maxDisplayRate = 30.0f;
+
+    // Drops points landing on a pixel already drawn, so the point count is bounded by the pane's pixel area.
+    PlotDecimator pixelThinning;
+    std::atomic<int> pixelWidth;
 
     glm::vec2 lastPosition;
     glm::vec2 lastSize;
-    bool updateGraphics;
-    std::mutex graphicsUpdateLock;
 
     WindowedSincFilter windowedSincFilter;
+    SampleBlock<std::complex<float>> decimatedSamples;
     void FormDecimator();
 
 public:
@@ -26,12 +64,19 @@ public:
 
     // Inherited via FilterBase
     virtual std::string GetName() const override;
-    virtual void Process(std::vector<unsigned char>* block) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+    virtual void Accumulate(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+    virtual bool HasUnpresentedResults() override;
+
+    IqDisplayMode GetDisplayMode() const;
+    void SetDisplayMode(IqDisplayMode mode);
 
     // Inherited via IPaneRenderable
     virtual bool HasTitleUpdate() override;
     virtual std::string GetTitle() override;
     virtual void Update(float elapsedTime, float frameTime) override;
     virtual void Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size) override;
+    virtual void SetVisibleRange(float start, float stop, int pixelWidth) override;
+    virtual void SetVisible(bool visible) override;
 };
 
@@ -1,12 +1,15 @@
 #include <algorithm>
+#include "AsyncLogger.h"
 #include "Spectrum.h"
 
 Spectrum::Spectrum(glm::vec2 startPosition, glm::vec2 startSize, SdrBuffer* dataBuffer)
     : lastPosition(startPosition), lastSize(startSize),
-      updateGraphics(false), spectrumLines(true),
+      snapshots(), spectrumLines(true, 16384, PlotVertexFormat::ImplicitX), amplitudes(), pixelWidth(0),
       windowedSincFilter(), FilterBase(dataBuffer)
 {
     FormDecimator();
+    spectrumLines.SetSeriesColor(glm::vec3(0.50f, 0.50f, 1.0f));
+    SetDisplayRate(maxDisplayRate);
     enabled = true;
 }
 
@@ -32,43 +35,40 @@ std::string Spectrum::GetName() const
     return "Spectrum";
 }
 
-void Spectrum::Process(std::vector<unsigned char>* block)
+void Spectrum::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
 {
+    TRACE_SCOPE("Spectrum::Process");
     // Logger::Log("Processing block of ", block->size(), " elements in filter '", GetName(), "'.");
 
     // Displays the IQ spectrum flattened on the XY plane.
-    float scale = (1.0f / 127.5f) * std::min(lastSize.x, lastSize.y);
-
-    graphicsUpdateLock.lock();
-    spectrumLines.Clear();
-    Logger::Log("Size block:", block->size(), " decimator:", windowedSincFilter.kernel.size(), ".");
-    int samples = block->size() / 2;
-    int steps = (samples - windowedSincFilter.kernel.size()) / windowedSincFilter.kernel.size();
-    int counter = 0;
-    for (unsigned int n = 0; n < samples - windowedSincFilter.kernel.size(); n += windowedSincFilter.kernel.size()) // n < block->size() / 2; n++)
+    float scale = std::min(lastSize.x, lastSize.y);
+
+    // TODO determine how to properly decimate IQ signals.
+    // TODO this leads to discontinuities at edges. We should grab two buffers and process that to avoid boundary problems.
+    // TODO there are weird artefacts using these decimation factors (scaling & descaling).
+    windowedSincFilter.Decimate(block, windowedSincFilter.kernel.size(), decimatedSamples);
+
+    ASYNC_LOG("Size block:", block.size(), " decimator:", windowedSincFilter.kernel.size(), ".");
+    amplitudes.clear();
+    for (unsigned int n = 0; n < decimatedSamples.size(); n++)
     {
-        // TODO determine how to properly decimate IQ signals.
-        // TODO this leads to discontinuities at edges. We should grab two buffers and process that to avoid boundary problems.
-        float i = 0;
-        float q = 0;
-        for (unsigned int m = 0; m < windowedSincFilter.kernel.size(); m++)
-        {
-            // TODO there are weird artefacts using these decimation factors (scaling & descaling).s
-            i += ((float)(*block)[(n + m) * 2] - 127.5f) * scale * windowedSincFilter.kernel[m];
-            q += ((float)(*block)[(n + m) * 2 + 1] - 127.5f) * scale * windowedSincFilter.kernel[m];
-        }
-        
-        float amplitude = std::sqrt(i * i + q * q);
+        float amplitude = std::abs(decimatedSamples[n]) * scale;
         amplitude = std::min(amplitude, lastSize.y / 2.0f);
         amplitude = std::max(amplitude, -lastSize.y / 2.0f);
-        
-        spectrumLines.positionBuffer.vertices.push_back(glm::vec3(lastPosition.x + ((float)counter / (float)steps) * lastSize.x, lastPosition.y + amplitude + lastSize.y / 2.0f, 0.0f));
-        spectrumLines.colorBuffer.vertices.push_back(glm::vec3(0.50f, 0.50f, 1.0f));
-        ++counter;
+
+        amplitudes.push_back(lastPosition.y + amplitude + lastSize.y / 2.0f);
     }
 
-    graphicsUpdateLock.unlock();
-    updateGraphics = true;
+    SeriesSnapshot& snapshot = snapshots.GetWriteBuffer();
+    PlotDecimator::MinMaxEnvelope(amplitudes, (unsigned int)std::max(pixelWidth.load(), 0), snapshot.values);
+    snapshot.xOrigin = lastPosition.x;
+    snapshot.xStep = lastSize.x / (float)std::max(snapshot.values.size(), (std::size_t)1);
+    snapshots.Publish();
+}
+
+bool Spectrum::HasUnpresentedResults()
+{
+    return snapshots.HasUnread();
 }
 
 bool Spectrum::HasTitleUpdate()
@@ -83,13 +83,9 @@ std::string Spectrum::GetTitle()
 
 void Spectrum::Update(float elapsedTime, float frameTime)
 {
-    if (updateGraphics)
+    if (snapshots.Acquire())
     {
-        graphicsUpdateLock.lock();
-        spectrumLines.Update();
-        graphicsUpdateLock.unlock();
-
-        updateGraphics = false;
+        spectrumLines.Update(snapshots.GetReadBuffer());
     }
 }
 
@@ -101,6 +97,16 @@ void Spectrum::Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec
     spectrumLines.Render(projectionMatrix);
 }
 
+void Spectrum::SetVisibleRange(float start, float stop, int pixelWidth)
+{
+    this->pixelWidth = pixelWidth;
+}
+
+void Spectrum::SetVisible(bool visible)
+{
+    SetPresented(visible);
+}
+
 Spectrum::~Spectrum()
 {
     StopFilter();
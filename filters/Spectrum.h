@@ -1,23 +1,35 @@
 #pragma once
+#include <atomic>
 #include <string>
 #include <GL/glew.h>
 #include "FilterBase.h"
 #include "GuCommon\vertex\PositionVbo.hpp"
 #include "GuCommon\vertex\ColorVbo.hpp"
+#include "math\PlotDecimator.h"
 #include "math\WindowedSincFilter.h"
 #include "IPaneRenderable.h"
+#include "TripleBuffer.h"
 #include "LineRenderer.h"
 
 class Spectrum : public FilterBase, public IPaneRenderable
 {
     LineRenderer spectrumLines;
 
+    // Amplitudes of every decimated sample, reduced to a min/max envelope of the pane's pixel columns.
+    std::vector<float> amplitudes;
+    std::atomic<int> pixelWidth;
+
     glm::vec2 lastPosition;
     glm::vec2 lastSize;
-    bool updateGraphics;
-    std::mutex graphicsUpdateLock;
+
+    // Each processed block's vertices, handed to the render thread without either side blocking.
+    TripleBuffer<SeriesSnapshot> snapshots;
+
+    // The plot is rebuilt at most this often, plus only once the last one was drawn.
+    const float maxDisplayRate = 30.0f;
 
     WindowedSincFilter windowedSincFilter;
+    SampleBlock<std::complex<float>> decimatedSamples;
     void FormDecimator();
 
 public:
@@ -26,12 +38,15 @@ public:
 
     // Inherited via FilterBase
     virtual std::string GetName() const override;
-    virtual void Process(std::vector<unsigned char>* block) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+    virtual bool HasUnpresentedResults() override;
 
     // Inherited via IPaneRenderable
     virtual bool HasTitleUpdate() override;
     virtual std::string GetTitle() override;
     virtual void Update(float elapsedTime, float frameTime) override;
     virtual void Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size) override;
+    virtual void SetVisibleRange(float start, float stop, int pixelWidth) override;
+    virtual void SetVisible(bool visible) override;
 };
 
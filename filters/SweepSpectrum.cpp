@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include "SweepSpectrum.h"
+
+SweepSpectrum::SweepSpectrum(glm::vec2 startPosition, glm::vec2 startSize, SweepScanner* sweepScanner)
+    : sweepScanner(sweepScanner), spectrumLines(true), spectrum(), displayedSweeps(0),
+      lastPosition(startPosition), lastSize(startSize)
+{
+}
+
+bool SweepSpectrum::HasTitleUpdate()
+{
+    return sweepScanner->GetCompletedSweeps() != displayedSweeps;
+}
+
+std::string SweepSpectrum::GetTitle()
+{
+    std::stringstream title;
+    title << "Sweep " << sweepScanner->GetStartFrequency() / 1000000 << "-" << sweepScanner->GetStopFrequency() / 1000000 << " MHz";
+    if (sweepScanner->GetCompletedSweeps() != 0)
+    {
+        title << " (" << sweepScanner->GetSweepRate() << " MHz/s)";
+    }
+
+    return title.str();
+}
+
+void SweepSpectrum::Update(float elapsedTime, float frameTime)
+{
+    // Only redraw when a full sweep completes, as copying the wideband spectrum is expensive.
+    unsigned int completedSweeps = sweepScanner->GetCompletedSweeps();
+    if (completedSweeps == displayedSweeps)
+    {
+        return;
+    }
+
+    displayedSweeps = completedSweeps;
+    sweepScanner->GetSpectrum(spectrum);
+    if (spectrum.empty())
+    {
+        return;
+    }
+
+    float minPower = *std::min_element(spectrum.begin(), spectrum.end());
+    float maxPower = *std::max_element(spectrum.begin(), spectrum.end());
+    float powerRange = std::max(maxPower - minPower, 1.0f);
+
+    unsigned int points = std::min((unsigned int)spectrum.size(), maxDisplayedPoints);
+    unsigned int binsPerPoint = (unsigned int)spectrum.size() / points;
+
+    spectrumLines.Clear();
+    for (unsigned int i = 0; i < points; i++)
+    {
+        float peak = *std::max_element(spectrum.begin() + i * binsPerPoint, spectrum.begin() + (i + 1) * binsPerPoint);
+        float xPosition = lastPosition.x + ((float)i / (float)points) * lastSize.x;
+        float yPosition = lastPosition.y + ((peak - minPower) / powerRange) * lastSize.y;
+
+        spectrumLines.positionBuffer.vertices.push_back(glm::vec3(xPosition, yPosition, 0.0f));
+        spectrumLines.colorBuffer.vertices.push_back(glm::vec3(0.0f, 1.0f, 0.5f));
+    }
+
+    spectrumLines.Update();
+}
+
+void SweepSpectrum::Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size)
+{
+    lastPosition = position;
+    lastSize = size;
+
+    spectrumLines.Render(projectionMatrix);
+}
+
+SweepSpectrum::~SweepSpectrum()
+{
+}
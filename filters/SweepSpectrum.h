@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "sdr\SweepScanner.h"
+#include "IPaneRenderable.h"
+#include "LineRenderer.h"
+
+// Displays the stitched wideband power spectrum produced by a sweep scanner.
+class SweepSpectrum : public IPaneRenderable
+{
+    // The wideband spectrum has far more bins than pixels, so it is reduced to the peak of each group of bins.
+    const unsigned int maxDisplayedPoints = 2048;
+
+    SweepScanner* sweepScanner;
+    LineRenderer spectrumLines;
+
+    std::vector<float> spectrum;
+    unsigned int displayedSweeps;
+
+    glm::vec2 lastPosition;
+    glm::vec2 lastSize;
+
+public:
+    SweepSpectrum(glm::vec2 startPosition, glm::vec2 startSize, SweepScanner* sweepScanner);
+    virtual ~SweepSpectrum();
+
+    // Inherited via IPaneRenderable
+    virtual bool HasTitleUpdate() override;
+    virtual std::string GetTitle() override;
+    virtual void Update(float elapsedTime, float frameTime) override;
+    virtual void Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size) override;
+};
+
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+
+// Hands the latest complete value from one writer thread to one reader thread, without either ever waiting on the other.
+// The writer fills its own buffer and publishes it; the reader picks up whichever buffer was published last. The third
+//  buffer sits between them, so a value published while the reader is still using the previous one is never torn.
+// Values published between two reads are dropped, so this suits snapshots where only the newest matters.
+template<typename T>
+class TripleBuffer
+{
+    static const unsigned int indexMask = 3;
+
+    // Set in the shared index when the buffer it refers to was published and hasn't been read yet.
+    static const unsigned int freshBit = 4;
+
+    T buffers[3];
+    std::atomic<unsigned int> shared;
+
+    // Only used by the writer and the reader respectively.
+    unsigned int writing;
+    unsigned int reading;
+
+public:
+    TripleBuffer()
+        : shared(1), writing(0), reading(2)
+    {
+    }
+
+    // The buffer for the writer to fill. It still holds whatever was in it last, so containers keep their capacity.
+    T& GetWriteBuffer()
+    {
+        return buffers[writing];
+    }
+
+    // Publishes the write buffer, replacing any unread value, and swaps in a free buffer to write next.
+    void Publish()
+    {
+        unsigned int previous = shared.exchange(writing | freshBit, std::memory_order_acq_rel);
+        writing = previous & indexMask;
+    }
+
+    // Takes the most recently published value into the read buffer. Returns false, leaving the read buffer as it was,
+    //  if nothing was published since the last read.
+    bool Acquire()
+    {
+        if ((shared.load(std::memory_order_relaxed) & freshBit) == 0)
+        {
+            return false;
+        }
+
+        unsigned int previous = shared.exchange(reading, std::memory_order_acq_rel);
+        reading = previous & indexMask;
+        return true;
+    }
+
+    // Returns true if a published value is waiting to be read.
+    bool HasUnread() const
+    {
+        return (shared.load(std::memory_order_relaxed) & freshBit) != 0;
+    }
+
+    // The value taken by the last successful Acquire.
+    T& GetReadBuffer()
+    {
+        return buffers[reading];
+    }
+};
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include "WaterfallSpectrum.h"
+
+WaterfallSpectrum::WaterfallSpectrum(SdrBuffer* dataBuffer)
+    : powerSpectrum(fftSize, SpectrumWindow::Blackman, 0.5f), powerDb(), waterfall(fftSize, historyRows), pendingRows(),
+      visibleStart(0.0f), visibleStop(1.0f), updateGraphics(false), FilterBase(dataBuffer)
+{
+    // Each row is the mean of one block's segments.
+    powerSpectrum.SetAveraging(SpectrumAveraging::Linear, 0.0f);
+    enabled = true;
+}
+
+std::string WaterfallSpectrum::GetName() const
+{
+    return "Waterfall";
+}
+
+void WaterfallSpectrum::OnTuningChanged(const BlockMetadata& metadata)
+{
+    powerSpectrum.Reset();
+}
+
+void WaterfallSpectrum::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("WaterfallSpectrum::Process");
+    powerSpectrum.AddSamples(block);
+    if (powerSpectrum.GetSegmentCount() == 0)
+    {
+        return;
+    }
+
+    powerSpectrum.GetPowerDb(powerDb);
+    powerSpectrum.Reset();
+
+    graphicsUpdateLock.lock();
+
+    // If rendering has stalled, only the most recent history is worth uploading.
+    if (pendingRows.size() >= (std::size_t)historyRows * fftSize)
+    {
+        pendingRows.erase(pendingRows.begin(), pendingRows.begin() + fftSize);
+    }
+
+    for (unsigned int i = 0; i < fftSize; i++)
+    {
+        float level = (powerDb[i] - minDisplayPower) / (maxDisplayPower - minDisplayPower);
+        pendingRows.push_back((unsigned char)(std::min(std::max(level, 0.0f), 1.0f) * 255.0f));
+    }
+
+    graphicsUpdateLock.unlock();
+    updateGraphics = true;
+}
+
+bool WaterfallSpectrum::HasTitleUpdate()
+{
+    return false;
+}
+
+std::string WaterfallSpectrum::GetTitle()
+{
+    return "Waterfall (-100 to 0 dBFS)";
+}
+
+void WaterfallSpectrum::SetVisibleRange(float start, float stop, int pixelWidth)
+{
+    visibleStart = start;
+    visibleStop = stop;
+}
+
+void WaterfallSpectrum::Update(float elapsedTime, float frameTime)
+{
+    if (updateGraphics)
+    {
+        graphicsUpdateLock.lock();
+        for (std::size_t row = 0; row < pendingRows.size(); row += fftSize)
+        {
+            waterfall.AddRow(pendingRows.data() + row);
+        }
+
+        pendingRows.clear();
+        graphicsUpdateLock.unlock();
+
+        updateGraphics = false;
+    }
+}
+
+void WaterfallSpectrum::Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size)
+{
+    waterfall.Render(projectionMatrix, position, size, visibleStart, visibleStop);
+}
+
+void WaterfallSpectrum::SetVisible(bool visible)
+{
+    SetPresented(visible);
+}
+
+WaterfallSpectrum::~WaterfallSpectrum()
+{
+    StopFilter();
+}
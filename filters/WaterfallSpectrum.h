@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "FilterBase.h"
+#include "math\PowerSpectrum.h"
+#include "IPaneRenderable.h"
+#include "WaterfallRenderer.h"
+
+// Displays the power spectrum of each block as a row of a scrolling waterfall, newest at the top.
+class WaterfallSpectrum : public FilterBase, public IPaneRenderable
+{
+    // Matches the FrequencySpectrum, so the two line up.
+    const unsigned int fftSize = 1024;
+
+    // About 28 seconds of history at 2.4 MS/s.
+    const unsigned int historyRows = 512;
+
+    // The colormap spans this range.
+    const float minDisplayPower = -100.0f;
+    const float maxDisplayPower = 0.0f;
+
+    PowerSpectrum powerSpectrum;
+    std::vector<float> powerDb;
+    WaterfallRenderer waterfall;
+
+    // Rows processed but not yet uploaded, one after the other. Bounded to the history depth.
+    std::vector<unsigned char> pendingRows;
+
+    float visibleStart;
+    float visibleStop;
+
+    // Rows queue up rather than replace each other, so these stay behind a lock.
+    std::atomic<bool> updateGraphics;
+    std::mutex graphicsUpdateLock;
+
+public:
+    WaterfallSpectrum(SdrBuffer* dataBuffer);
+    virtual ~WaterfallSpectrum();
+
+    // Inherited via FilterBase
+    virtual std::string GetName() const override;
+    virtual void OnTuningChanged(const BlockMetadata& metadata) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+
+    // Inherited via IPaneRenderable
+    virtual bool HasTitleUpdate() override;
+    virtual std::string GetTitle() override;
+    virtual void Update(float elapsedTime, float frameTime) override;
+    virtual void Render(glm::mat4 & projectionMatrix, glm::vec2 position, glm::vec2 size) override;
+    virtual void SetVisibleRange(float start, float stop, int pixelWidth) override;
+    virtual void SetVisible(bool visible) override;
+};
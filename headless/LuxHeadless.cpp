@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logging\Logger.h"
+#include "metrics\MetricsRegistry.h"
+#include "metrics\Tracer.h"
+#include "sdr\FileSampleSource.h"
+#include "sdr\SdrBuffer.h"
+#include "sdr\SyntheticSampleSource.h"
+#include "AMAudioTransformer.h"
+#include "AsyncLogger.h"
+#include "FMAudioTransformer.h"
+#include "PipelineConfig.h"
+#include "PipelineStages.h"
+
+#pragma comment(lib, "lib/sfml-audio")
+#pragma comment(lib, "lib/sfml-system")
+
+// Runs the acquisition and filter pipeline without a window, fed as fast as the source can deliver, and reports
+//  the throughput of each stage. Usage: LuxHeadless [--config file] [key=value ...], see PipelineConfig.
+int main(int argc, char* argv[])
+{
+    Logger::Setup("lux-headless.log", true);
+
+    PipelineConfig config;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument(argv[i]);
+        bool applied = argument == "--config" && i + 1 < argc ? config.Load(argv[++i]) : config.Apply(argument);
+        if (!applied)
+        {
+            Logger::Shutdown();
+            return 1;
+        }
+    }
+
+    config.Log();
+
+    ISampleSource* source = nullptr;
+    if (config.source == "file")
+    {
+        FileSampleSource* fileSource = new FileSampleSource(config.file, config.centerFrequency, config.sampleRate);
+        if (!fileSource->Open())
+        {
+            delete fileSource;
+            Logger::Shutdown();
+            return 1;
+        }
+
+        source = fileSource;
+    }
+    else
+    {
+        source = new SyntheticSampleSource(config.centerFrequency, config.sampleRate);
+    }
+
+    AsyncLogger::Start();
+    SdrBuffer* dataBuffer = new SdrBuffer(source, 0, config.bufferBlocks);
+
+    std::vector<FilterBase*> stages;
+    for (const std::string& stage : config.stages)
+    {
+        if (stage == "spectrum")
+        {
+            stages.push_back(new SpectrumStage(dataBuffer, config.fftSize));
+        }
+        else if (stage == "decimation")
+        {
+            stages.push_back(new DecimationStage(dataBuffer, config.decimation));
+        }
+        else if (stage == "fm")
+        {
+            stages.push_back(new DemodulationStage(dataBuffer, "FM", new FMAudioTransformer()));
+        }
+        else if (stage == "am")
+        {
+            stages.push_back(new DemodulationStage(dataBuffer, "AM", new AMAudioTransformer()));
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    dataBuffer->StartAcquisition();
+
+    unsigned int samplesPerBlock = dataBuffer->GetReadSize() / 2;
+    unsigned int lastBlockId = 0;
+    for (float remaining = config.seconds; remaining > 0.0f; remaining -= 1.0f)
+    {
+        float interval = std::min(remaining, 1.0f);
+        std::this_thread::sleep_for(std::chrono::duration<float>(interval));
+
+        unsigned int blockId = dataBuffer->GetCurrentBlockId();
+        Logger::Log("Acquiring at ", (double)(blockId - lastBlockId) * samplesPerBlock / interval / 1e6, " MS/s.");
+        lastBlockId = blockId;
+    }
+
+    dataBuffer->StopAcquisition();
+    dataBuffer->WaitForAcquisitionStop();
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Blocks still buffered when acquisition stopped are neither processed nor dropped, so aren't counted.
+    double acquiredSamples = (double)dataBuffer->GetCurrentBlockId() * samplesPerBlock;
+    Logger::Log("Acquired ", acquiredSamples / 1e6, " MS in ", elapsedSeconds, " s: ", acquiredSamples / elapsedSeconds / 1e6, " MS/s, ",
+        dataBuffer->GetDroppedReads(), " dropped reads.");
+
+    for (FilterBase* stage : stages)
+    {
+        double processedSamples = (double)stage->GetProcessedBlocks() * samplesPerBlock;
+        double busySeconds = stage->GetBusySeconds();
+
+        // Throughput is what kept up with the source; capacity is what the stage could sustain on its own thread.
+        Logger::Log(stage->GetName(), ": ", processedSamples / elapsedSeconds / 1e6, " MS/s processed, ",
+            busySeconds > 0.0 ? processedSamples / busySeconds / 1e6 : 0.0, " MS/s capacity, ",
+            busySeconds, " s busy (", 100.0 * busySeconds / elapsedSeconds, "%), ",
+            stage->GetProcessedBlocks(), " blocks processed, ", stage->GetDroppedBlocks(), " dropped.");
+
+        SpectrumStage* spectrumStage = dynamic_cast<SpectrumStage*>(stage);
+        if (spectrumStage != nullptr)
+        {
+            Logger::Log(stage->GetName(), ": ", spectrumStage->GetDetectionCount(), " signal detections.");
+        }
+    }
+
+    // The latency distributions are only in the metrics, so keep them alongside the log.
+    Logger::Log("Metrics snapshot written to 'lux-headless-metrics.json': ", MetricsRegistry::WriteSnapshot("lux-headless-metrics.json"));
+    if (!config.tracePath.empty())
+    {
+        Tracer::WriteChromeTrace(config.tracePath);
+    }
+
+    for (FilterBase* stage : stages)
+    {
+        delete stage;
+    }
+
+    delete dataBuffer;
+    delete source;
+    AsyncLogger::Stop();
+    Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <fstream>
+#include <sstream>
+#include "logging\Logger.h"
+#include "PipelineConfig.h"
+
+PipelineConfig::PipelineConfig()
+    : source("synthetic"), file(), centerFrequency(100000000), sampleRate(2400000), seconds(10.0f), bufferBlocks(30),
+      stages({ "spectrum", "decimation", "fm" }), fftSize(1024), decimation(1024), tracePath()
+{
+}
+
+bool PipelineConfig::Apply(const std::string& setting)
+{
+    std::size_t separator = setting.find('=');
+    if (separator == std::string::npos)
+    {
+        Logger::LogError("Expected a key=value setting, not '", setting, "'.");
+        return false;
+    }
+
+    std::string key = setting.substr(0, separator);
+    std::string value = setting.substr(separator + 1);
+    std::istringstream valueStream(value);
+
+    bool parsed = true;
+    if (key == "source")
+    {
+        source = value;
+        parsed = source == "synthetic" || source == "file";
+    }
+    else if (key == "file")
+    {
+        file = value;
+    }
+    else if (key == "centerFrequency")
+    {
+        parsed = (bool)(valueStream >> centerFrequency);
+    }
+    else if (key == "sampleRate")
+    {
+        parsed = (bool)(valueStream >> sampleRate);
+    }
+    else if (key == "seconds")
+    {
+        parsed = (bool)(valueStream >> seconds) && seconds > 0.0f;
+    }
+    else if (key == "bufferBlocks")
+    {
+        parsed = (bool)(valueStream >> bufferBlocks) && bufferBlocks > 1;
+    }
+    else if (key == "fftSize")
+    {
+        parsed = (bool)(valueStream >> fftSize) && fftSize > 0 && (fftSize & (fftSize - 1)) == 0;
+    }
+    else if (key == "decimation")
+    {
+        parsed = (bool)(valueStream >> decimation) && decimation > 0;
+    }
+    else if (key == "trace")
+    {
+        tracePath = value;
+    }
+    else if (key == "stages")
+    {
+        stages.clear();
+        std::string stage;
+        while (std::getline(valueStream, stage, ','))
+        {
+            if (stage != "spectrum" && stage != "decimation" && stage != "fm" && stage != "am")
+            {
+                Logger::LogError("Unknown pipeline stage '", stage, "'.");
+                return false;
+            }
+
+            stages.push_back(stage);
+        }
+    }
+    else
+    {
+        Logger::LogError("Unknown setting '", key, "'.");
+        return false;
+    }
+
+    if (!parsed)
+    {
+        Logger::LogError("Invalid value '", value, "' for setting '", key, "'.");
+    }
+
+    return parsed;
+}
+
+bool PipelineConfig::Load(const std::string& path)
+{
+    std::ifstream configFile(path);
+    if (!configFile)
+    {
+        Logger::LogError("Unable to open the pipeline configuration '", path, "'.");
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(configFile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        if (!Apply(line))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PipelineConfig::Log() const
+{
+    std::string stageList;
+    for (const std::string& stage : stages)
+    {
+        stageList += stageList.empty() ? stage : "," + stage;
+    }
+
+    Logger::Log("Source: ", source, source == "file" ? " (" + file + ")" : "", " at ", sampleRate, " S/s, ", centerFrequency, " Hz.");
+    Logger::Log("Running stages [", stageList, "] for ", seconds, " s with ", bufferBlocks, " buffered blocks.");
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Settings for a headless pipeline run, read as key=value lines from a file and/or the command line.
+// Lines starting with '#' are comments. Later settings override earlier ones.
+struct PipelineConfig
+{
+    // "synthetic" or "file".
+    std::string source;
+
+    // Raw 8-bit I/Q recording to replay, for the file source.
+    std::string file;
+
+    unsigned int centerFrequency;
+    unsigned int sampleRate;
+
+    // How long to run for, after which statistics are reported.
+    float seconds;
+
+    // Blocks kept in the rolling buffer. Filters that fall further behind than this drop blocks.
+    unsigned int bufferBlocks;
+
+    // Stages to run on the stream, each on its own thread: spectrum, decimation, fm, am.
+    std::vector<std::string> stages;
+
+    // Spectrum stage FFT size and decimation stage factor.
+    unsigned int fftSize;
+    unsigned int decimation;
+
+    // Chrome trace of the run to write at the end, if set.
+    std::string tracePath;
+
+    PipelineConfig();
+
+    // Applies a single key=value setting, returning false if it isn't recognized.
+    bool Apply(const std::string& setting);
+
+    // Applies each setting in the file, returning false if it can't be read or a setting isn't recognized.
+    bool Load(const std::string& path);
+
+    void Log() const;
+};
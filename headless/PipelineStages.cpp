@@ -0,0 +1,100 @@
+#include "PipelineStages.h"
+
+SpectrumStage::SpectrumStage(SdrBuffer* dataBuffer, unsigned int fftSize)
+    : powerSpectrum(fftSize, SpectrumWindow::Blackman, 0.5f), power(), detector(CfarMethod::OrderedStatistic, 16, 2, 1e-6f),
+      detections(0), FilterBase(dataBuffer)
+{
+    powerSpectrum.SetAveraging(SpectrumAveraging::Exponential, 0.01f);
+    enabled = true;
+}
+
+unsigned int SpectrumStage::GetDetectionCount() const
+{
+    return detections;
+}
+
+std::string SpectrumStage::GetName() const
+{
+    return "Spectrum";
+}
+
+void SpectrumStage::OnTuningChanged(const BlockMetadata& metadata)
+{
+    powerSpectrum.Reset();
+}
+
+void SpectrumStage::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("SpectrumStage::Process");
+    powerSpectrum.AddSamples(block);
+    powerSpectrum.GetPower(power);
+
+    double binWidth = (double)metadata.sampleRate / (double)powerSpectrum.GetFftSize();
+    double lowestFrequency = (double)metadata.centerFrequency - (double)metadata.sampleRate / 2.0;
+    detector.Detect(power, lowestFrequency, binWidth, metadata.captureTime);
+
+    // Nothing consumes the detections, so drain them to keep the queue from filling.
+    SignalDetection detection;
+    while (detector.PopDetection(detection))
+    {
+        ++detections;
+    }
+}
+
+SpectrumStage::~SpectrumStage()
+{
+    StopFilter();
+}
+
+DecimationStage::DecimationStage(SdrBuffer* dataBuffer, unsigned int decimation)
+    : windowedSincFilter(), decimatedSamples(), decimation(decimation), FilterBase(dataBuffer)
+{
+    // Matches the IQSpectrum's 3.71 kHz filter, with a kernel as long as the decimation.
+    windowedSincFilter.CreateFilter(3710, decimation);
+    enabled = true;
+}
+
+std::string DecimationStage::GetName() const
+{
+    return "Decimation";
+}
+
+void DecimationStage::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("DecimationStage::Process");
+    windowedSincFilter.Decimate(block, decimation, decimatedSamples);
+}
+
+DecimationStage::~DecimationStage()
+{
+    StopFilter();
+}
+
+DemodulationStage::DemodulationStage(SdrBuffer* dataBuffer, std::string name, IAudioTransformer* audioTransformer)
+    : name(name), audioTransformer(audioTransformer), audio(), FilterBase(dataBuffer)
+{
+    enabled = true;
+}
+
+std::string DemodulationStage::GetName() const
+{
+    return name;
+}
+
+void DemodulationStage::OnTuningChanged(const BlockMetadata& metadata)
+{
+    audioTransformer->Reset();
+}
+
+void DemodulationStage::Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata)
+{
+    TRACE_SCOPE("DemodulationStage::Process");
+    audio.clear();
+    audioTransformer->Process(GetRawSamples(metadata), block, &audio);
+}
+
+DemodulationStage::~DemodulationStage()
+{
+    StopFilter();
+    delete audioTransformer;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+#include <SFML\Audio.hpp>
+#include "filters\FilterBase.h"
+#include "math\CfarDetector.h"
+#include "math\PowerSpectrum.h"
+#include "math\WindowedSincFilter.h"
+#include "IAudioTransformer.h"
+
+// The processing behind each display filter, without the rendering, so pipelines can run without a window.
+
+// Averaged full-band power spectrum and signal detection, as the FrequencySpectrum computes them.
+class SpectrumStage : public FilterBase
+{
+    PowerSpectrum powerSpectrum;
+    std::vector<float> power;
+    CfarDetector detector;
+    std::atomic<unsigned int> detections;
+
+public:
+    SpectrumStage(SdrBuffer* dataBuffer, unsigned int fftSize);
+    virtual ~SpectrumStage();
+
+    unsigned int GetDetectionCount() const;
+
+    // Inherited via FilterBase
+    virtual std::string GetName() const override;
+    virtual void OnTuningChanged(const BlockMetadata& metadata) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+};
+
+// Windowed-sinc low-pass filtering and decimation, as the IQSpectrum and Spectrum compute them.
+class DecimationStage : public FilterBase
+{
+    WindowedSincFilter windowedSincFilter;
+    SampleBlock<std::complex<float>> decimatedSamples;
+    unsigned int decimation;
+
+public:
+    DecimationStage(SdrBuffer* dataBuffer, unsigned int decimation);
+    virtual ~DecimationStage();
+
+    // Inherited via FilterBase
+    virtual std::string GetName() const override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+};
+
+// Demodulation to audio, as the AudioStream runs it. The audio is discarded rather than played.
+class DemodulationStage : public FilterBase
+{
+    std::string name;
+    IAudioTransformer* audioTransformer;
+    std::vector<sf::Int16> audio;
+
+public:
+    // Takes ownership of the transformer.
+    DemodulationStage(SdrBuffer* dataBuffer, std::string name, IAudioTransformer* audioTransformer);
+    virtual ~DemodulationStage();
+
+    // Inherited via FilterBase
+    virtual std::string GetName() const override;
+    virtual void OnTuningChanged(const BlockMetadata& metadata) override;
+    virtual void Process(SampleView<const std::complex<float>> block, const BlockMetadata& metadata) override;
+};
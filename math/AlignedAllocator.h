@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+// Allocates memory aligned for SIMD loads and stores, for use in standard containers.
+template<typename T, std::size_t Alignment = 32>
+class AlignedAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator()
+    {
+    }
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        if (count == 0)
+        {
+            return nullptr;
+        }
+
+#ifdef _WIN32
+        void* memory = _aligned_malloc(count * sizeof(T), Alignment);
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, Alignment, count * sizeof(T)) != 0)
+        {
+            memory = nullptr;
+        }
+#endif
+        if (memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, std::size_t)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const
+    {
+        return false;
+    }
+};
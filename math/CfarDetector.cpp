@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include "logging\Logger.h"
+#include "CfarDetector.h"
+#include "PowerSpectrum.h"
+
+CfarDetector::CfarDetector(CfarMethod method, unsigned int trainingCells, unsigned int guardCells, float falseAlarmRate)
+    : method(method), trainingCells(std::max(trainingCells, 1u)), guardCells(guardCells), orderedRank(0), thresholdFactor(1.0f),
+      prefixSums(), decibels(), levels(), histogram(histogramLevels), levelPowers(histogramLevels), noiseLevels(), detections()
+{
+    double cells = 2.0 * (double)this->trainingCells;
+    double logFalseAlarmRate = std::log((double)std::min(std::max(falseAlarmRate, 1e-12f), 0.5f));
+
+    // Rank of the estimate among the sorted training cells, counting from 0.
+    orderedRank = std::min(this->trainingCells * 2 - 1, this->trainingCells * 3 / 2);
+
+    if (method == CfarMethod::CellAveraging)
+    {
+        // Pfa = (1 + factor / N)^-N for the mean of N exponential cells.
+        thresholdFactor = (float)(cells * (std::exp(-logFalseAlarmRate / cells) - 1.0));
+    }
+    else
+    {
+        // Pfa = product over i < rank of (N - i) / (N - i + factor). This falls as the factor rises, so bisect for it.
+        auto logRate = [=](double factor)
+        {
+            double sum = 0.0;
+            for (unsigned int i = 0; i <= orderedRank; i++)
+            {
+                sum += std::log((cells - i) / (cells - i + factor));
+            }
+
+            return sum;
+        };
+
+        double low = 0.0;
+        double high = 1.0;
+        while (logRate(high) > logFalseAlarmRate)
+        {
+            high *= 2.0;
+        }
+
+        for (int iteration = 0; iteration < 64; iteration++)
+        {
+            double middle = (low + high) / 2.0;
+            (logRate(middle) > logFalseAlarmRate ? low : high) = middle;
+        }
+
+        thresholdFactor = (float)high;
+    }
+
+    for (unsigned int level = 0; level < histogramLevels; level++)
+    {
+        float levelDb = ((float)level + 0.5f) / (float)levelsPerDb - 200.0f;
+        levelPowers[level] = std::pow(10.0f, levelDb / 10.0f);
+    }
+}
+
+void CfarDetector::EstimateCellAveragingNoise(const std::vector<float>& power)
+{
+    // Prefix sums over the spectrum extended by a window's reach at each end, wrapping around. Doubles, so the
+    //  differences of large sums don't lose the small ones.
+    unsigned int count = (unsigned int)power.size();
+    unsigned int reach = guardCells + trainingCells;
+    prefixSums.resize(count + 2 * reach + 1);
+    prefixSums[0] = 0.0;
+    for (unsigned int i = 0; i < count + 2 * reach; i++)
+    {
+        prefixSums[i + 1] = prefixSums[i] + power[(i + count - reach) % count];
+    }
+
+    // Bin i is at extended index i + reach, with training cells [i, i + training) and (i + reach + guard, i + 2 reach].
+    float scale = 1.0f / (float)(2 * trainingCells);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        double sum = (prefixSums[i + trainingCells] - prefixSums[i]) + (prefixSums[i + 2 * reach + 1] - prefixSums[i + reach + guardCells + 1]);
+        noiseLevels[i] = (float)sum * scale;
+    }
+}
+
+void CfarDetector::EstimateOrderedStatisticNoise(const std::vector<float>& power)
+{
+    unsigned int count = (unsigned int)power.size();
+    decibels.resize(count);
+    levels.resize(count);
+    PowerSpectrum::ToDecibels(power.data(), decibels.data(), count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        int level = (int)((decibels[i] + 200.0f) * (float)levelsPerDb);
+        levels[i] = (unsigned int)std::min(std::max(level, 0), (int)histogramLevels - 1);
+    }
+
+    // The cursor is the histogram level holding the ranked cell, with belowCursor cells at lower levels.
+    unsigned int cursor = 0;
+    unsigned int belowCursor = 0;
+    auto update = [&](unsigned int level, int change)
+    {
+        histogram[level] += change;
+        if (level < cursor)
+        {
+            belowCursor += change;
+        }
+    };
+
+    std::fill(histogram.begin(), histogram.end(), 0);
+    unsigned int reach = guardCells + trainingCells;
+    for (unsigned int offset = guardCells + 1; offset <= reach; offset++)
+    {
+        update(levels[(count - offset) % count], 1);
+        update(levels[offset % count], 1);
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (i != 0)
+        {
+            // Slide both training ranges up one bin.
+            update(levels[(i - 1 + count - reach) % count], -1);
+            update(levels[(i - 1 + count - guardCells) % count], 1);
+            update(levels[(i + guardCells) % count], -1);
+            update(levels[(i + reach) % count], 1);
+        }
+
+        // Each slide moves the ranked cell by at most a few occupied levels, so this is O(1) amortized.
+        while (belowCursor > orderedRank)
+        {
+            --cursor;
+            belowCursor -= histogram[cursor];
+        }
+
+        while (belowCursor + histogram[cursor] <= orderedRank)
+        {
+            belowCursor += histogram[cursor];
+            ++cursor;
+        }
+
+        noiseLevels[i] = levelPowers[cursor];
+    }
+}
+
+unsigned int CfarDetector::Detect(const std::vector<float>& power, double lowestFrequency, double binWidth, std::chrono::steady_clock::time_point timestamp)
+{
+    unsigned int count = (unsigned int)power.size();
+    if (count <= 2 * (guardCells + trainingCells))
+    {
+        Logger::LogWarn("The CFAR window of ", 2 * (guardCells + trainingCells) + 1, " bins does not fit in a ", count, "-bin spectrum.");
+        return 0;
+    }
+
+    noiseLevels.resize(count);
+    if (method == CfarMethod::CellAveraging)
+    {
+        EstimateCellAveragingNoise(power);
+    }
+    else
+    {
+        EstimateOrderedStatisticNoise(power);
+    }
+
+    std::vector<SignalDetection> newDetections;
+    unsigned int i = 0;
+    while (i < count)
+    {
+        if (power[i] <= thresholdFactor * noiseLevels[i])
+        {
+            ++i;
+            continue;
+        }
+
+        // Merge the run of bins over threshold into one detection.
+        unsigned int start = i;
+        double totalPower = 0.0;
+        double weightedBin = 0.0;
+        float peakRatio = 0.0f;
+        while (i < count && power[i] > thresholdFactor * noiseLevels[i])
+        {
+            totalPower += power[i];
+            weightedBin += power[i] * (double)i;
+            peakRatio = std::max(peakRatio, power[i] / std::max(noiseLevels[i], 1e-20f));
+            ++i;
+        }
+
+        SignalDetection detection;
+        detection.timestamp = timestamp;
+        detection.frequency = lowestFrequency + (weightedBin / totalPower) * binWidth;
+        detection.bandwidth = (double)(i - start) * binWidth;
+        detection.snrDb = 10.0f * std::log10(peakRatio);
+        newDetections.push_back(detection);
+    }
+
+    detectionLock.lock();
+    detections.insert(detections.end(), newDetections.begin(), newDetections.end());
+    while (detections.size() > maxQueuedDetections)
+    {
+        detections.pop_front();
+    }
+
+    detectionLock.unlock();
+    return (unsigned int)newDetections.size();
+}
+
+const std::vector<float>& CfarDetector::GetNoiseLevels() const
+{
+    return noiseLevels;
+}
+
+float CfarDetector::GetThresholdFactor() const
+{
+    return thresholdFactor;
+}
+
+bool CfarDetector::PopDetection(SignalDetection& detection)
+{
+    detectionLock.lock();
+    bool hasDetection = !detections.empty();
+    if (hasDetection)
+    {
+        detection = detections.front();
+        detections.pop_front();
+    }
+
+    detectionLock.unlock();
+    return hasDetection;
+}
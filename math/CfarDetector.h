@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// How the noise level around each bin is estimated from its training cells.
+enum class CfarMethod
+{
+    // Mean of the training cells. Optimal in uniform noise, but masked by strong neighbouring signals.
+    CellAveraging,
+
+    // A fixed rank (three quarters of the way up) of the training cells. Tolerates neighbouring signals at a small cost in sensitivity.
+    OrderedStatistic
+};
+
+// A contiguous run of bins over the detection threshold.
+struct SignalDetection
+{
+    // Time the spectrum's samples were captured.
+    std::chrono::steady_clock::time_point timestamp;
+
+    // Power-weighted center of the run, and its width, in Hz.
+    double frequency;
+    double bandwidth;
+
+    // Peak bin power over the noise estimate at that bin, in dB.
+    float snrDb;
+};
+
+// Constant false alarm rate detector: flags each bin whose power exceeds a multiple of the noise level estimated
+//  from the training cells either side of it, skipping the guard cells adjacent to it.
+// The training window slides in O(1) per bin: cell-averaging uses prefix sums, and ordered-statistic tracks the rank
+//  through a histogram of quantized levels. The spectrum wraps around, as the band edges of complex samples are adjacent.
+class CfarDetector
+{
+    // Levels for the ordered-statistic histogram, in 0.25 dB steps from -200 dB.
+    static const unsigned int histogramLevels = 800;
+    static const unsigned int levelsPerDb = 4;
+
+    // Oldest detections are discarded beyond this, so an absent consumer can't grow the queue forever.
+    static const std::size_t maxQueuedDetections = 4096;
+
+    CfarMethod method;
+    unsigned int trainingCells;
+    unsigned int guardCells;
+    unsigned int orderedRank;
+
+    // Multiple of the noise estimate a bin must exceed, derived from the false alarm rate for exponentially-distributed noise power.
+    float thresholdFactor;
+
+    // Working state for the noise estimates. Power levels are the linear power at the center of each histogram level.
+    std::vector<double> prefixSums;
+    std::vector<float> decibels;
+    std::vector<unsigned int> levels;
+    std::vector<unsigned int> histogram;
+    std::vector<float> levelPowers;
+    std::vector<float> noiseLevels;
+
+    std::mutex detectionLock;
+    std::deque<SignalDetection> detections;
+
+    void EstimateCellAveragingNoise(const std::vector<float>& power);
+    void EstimateOrderedStatisticNoise(const std::vector<float>& power);
+
+public:
+    // Training and guard cells are per side. The false alarm rate is the probability of a noise-only bin being detected.
+    // Averaged spectra have less noise variance than a single FFT, so their actual false alarm rate is lower.
+    CfarDetector(CfarMethod method, unsigned int trainingCells, unsigned int guardCells, float falseAlarmRate);
+
+    // Detects signals in a spectrum of linear power, lowest frequency first, queueing a detection for each run of bins over threshold.
+    // Returns the number of detections.
+    unsigned int Detect(const std::vector<float>& power, double lowestFrequency, double binWidth, std::chrono::steady_clock::time_point timestamp);
+
+    // Noise estimate of each bin from the last call to Detect, in linear power.
+    const std::vector<float>& GetNoiseLevels() const;
+    float GetThresholdFactor() const;
+
+    // Removes the oldest queued detection, returning false if there are none. Thread-safe.
+    bool PopDetection(SignalDetection& detection);
+};
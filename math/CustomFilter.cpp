@@ -18,3 +18,8 @@ float CustomFilter::ComputeBlackmanWindowPt(int kernelIdx, int kernelLength)
 CustomFilter::CustomFilter()
 {
 }
+
+void CustomFilter::DecimateFixedPoint(SampleView<const ComplexInt16> samples, unsigned int decimationFactor, SampleBlock<ComplexInt16>& output) const
+{
+    FixedPoint::Decimate(samples, fixedPointKernel, decimationFactor, output);
+}
@@ -1,22 +1,52 @@
 #pragma once
+#include <complex>
 #include <vector>
+#include "FixedPoint.h"
+#include "SampleBlock.h"
 
 // Performs customized filter operations on a subset of data in various situations.
 class CustomFilter
 {
 protected:
-    // Computes a point on the following windows.
-    float ComputeHammingWindowPt(int kernelIdx, int kernelLength);
-    float ComputeBlackmanWindowPt(int kernelIdx, int kernelLength);
+    // Q15 copy of the kernel, which must be refreshed whenever the kernel changes.
+    FixedPointKernel fixedPointKernel;
 
 public:
     CustomFilter();
 
+    // Computes a point on the following windows.
+    static float ComputeHammingWindowPt(int kernelIdx, int kernelLength);
+    static float ComputeBlackmanWindowPt(int kernelIdx, int kernelLength);
+
     // Fills in the pre-allocated kernel with the filter to use.
     virtual void CreateFilter(int kernelLength) = 0;
 
+    // Convolves the kernel across the samples, producing one output for every decimationFactor inputs.
+    // Outputs that would need samples past the end of the input are not produced.
+    template<typename T>
+    void Decimate(SampleView<T> samples, unsigned int decimationFactor, SampleBlock<std::complex<float>>& output) const;
+
+    // As Decimate, but entirely in saturating Q15 arithmetic.
+    void DecimateFixedPoint(SampleView<const ComplexInt16> samples, unsigned int decimationFactor, SampleBlock<ComplexInt16>& output) const;
+
     // TODO This shouldn't be public, will refactor later.
     // The filter kernel to be applied to the data set.
     std::vector<float> kernel;
 };
 
+template<typename T>
+void CustomFilter::Decimate(SampleView<T> samples, unsigned int decimationFactor, SampleBlock<std::complex<float>>& output) const
+{
+    output.Clear();
+    for (std::size_t n = 0; n + kernel.size() <= samples.size(); n += decimationFactor)
+    {
+        std::complex<float> sum(0.0f, 0.0f);
+        for (std::size_t m = 0; m < kernel.size(); m++)
+        {
+            sum += SampleTraits<T>::ToComplexFloat(samples[n + m]) * kernel[m];
+        }
+
+        output.PushBack(sum);
+    }
+}
+
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include "FftPlan.h"
+
+std::mutex FftPlan::cacheLock;
+std::map<std::pair<unsigned int, FftDirection>, std::shared_ptr<const FftPlan>> FftPlan::cache;
+
+// Multiplies without the infinity and NaN handling of std::complex's operator*, which stops it being inlined.
+static inline std::complex<float> Multiply(std::complex<float> a, std::complex<float> b)
+{
+    return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+FftPlan::FftPlan(unsigned int size, FftDirection direction)
+    : size(std::max(size, 1u)), direction(direction), factors(), twiddles(), useBluestein(false), convolutionSize(0),
+      chirp(), kernelSpectrum(), convolutionForward(), convolutionInverse()
+{
+    const double twoPi = 6.283185307179586;
+    double sign = direction == FftDirection::Forward ? -1.0 : 1.0;
+
+    // Factor into 5s, 3s, 4s and 2s, so powers of 2 mostly use the cheaper radix-4 butterflies.
+    // Whatever remains needs Bluestein's algorithm.
+    unsigned int remaining = this->size;
+    const unsigned int radices[] = { 5, 3, 4, 2 };
+    for (unsigned int radix : radices)
+    {
+        while (remaining % radix == 0)
+        {
+            factors.push_back(radix);
+            remaining /= radix;
+        }
+    }
+
+    if (remaining != 1)
+    {
+        useBluestein = true;
+        factors.clear();
+
+        convolutionSize = 1;
+        while (convolutionSize < this->size * 2 - 1)
+        {
+            convolutionSize <<= 1;
+        }
+
+        // chirp[n] = e^(-+PI i n^2 / size). n^2 is reduced modulo 2 * size in integers, so large n lose no precision.
+        chirp.resize(this->size);
+        for (unsigned int n = 0; n < this->size; n++)
+        {
+            unsigned long long phase = ((unsigned long long)n * n) % (2ull * this->size);
+            chirp[n] = std::polar(1.0f, (float)(sign * twoPi * 0.5 * (double)phase / (double)this->size));
+        }
+
+        // The kernel is the conjugate chirp at offsets -(size - 1) to (size - 1), with negative offsets wrapped around the end.
+        convolutionForward = Get(convolutionSize, FftDirection::Forward);
+        convolutionInverse = Get(convolutionSize, FftDirection::Inverse);
+        std::vector<std::complex<float>> kernel(convolutionSize);
+        for (unsigned int n = 0; n < this->size; n++)
+        {
+            kernel[n] = std::conj(chirp[n]);
+            if (n != 0)
+            {
+                kernel[convolutionSize - n] = std::conj(chirp[n]);
+            }
+        }
+
+        kernelSpectrum.resize(convolutionSize);
+        convolutionForward->Execute(kernel.data(), kernelSpectrum.data());
+
+        // Fold the inverse transform's scaling into the kernel.
+        for (std::complex<float>& value : kernelSpectrum)
+        {
+            value /= (float)convolutionSize;
+        }
+    }
+    else
+    {
+        twiddles.resize(this->size);
+        for (unsigned int k = 0; k < this->size; k++)
+        {
+            twiddles[k] = std::polar(1.0f, (float)(sign * twoPi * (double)k / (double)this->size));
+        }
+    }
+}
+
+unsigned int FftPlan::GetSize() const
+{
+    return size;
+}
+
+FftDirection FftPlan::GetDirection() const
+{
+    return direction;
+}
+
+bool FftPlan::UsesBluestein() const
+{
+    return useBluestein;
+}
+
+void FftPlan::TransformMixedRadix(std::complex<float>* output, const std::complex<float>* input, unsigned int stride, unsigned int factorIndex) const
+{
+    // Decimation in time: transform each of the radix interleaved subsequences into consecutive runs of the output,
+    //  then combine the runs with radix-point butterflies.
+    unsigned int radix = factors[factorIndex];
+    unsigned int subSize = size / (stride * radix);
+    if (subSize == 1)
+    {
+        for (unsigned int q = 0; q < radix; q++)
+        {
+            output[q] = input[q * stride];
+        }
+    }
+    else
+    {
+        for (unsigned int q = 0; q < radix; q++)
+        {
+            TransformMixedRadix(output + q * subSize, input + q * stride, stride * radix, factorIndex + 1);
+        }
+    }
+
+    if (radix == 2)
+    {
+        for (unsigned int k = 0; k < subSize; k++)
+        {
+            std::complex<float> twiddled = Multiply(output[k + subSize], twiddles[k * stride]);
+            output[k + subSize] = output[k] - twiddled;
+            output[k] += twiddled;
+        }
+
+        return;
+    }
+
+    if (radix == 4)
+    {
+        for (unsigned int k = 0; k < subSize; k++)
+        {
+            std::complex<float> a0 = output[k];
+            std::complex<float> a1 = Multiply(output[k + subSize], twiddles[k * stride]);
+            std::complex<float> a2 = Multiply(output[k + 2 * subSize], twiddles[2 * k * stride]);
+            std::complex<float> a3 = Multiply(output[k + 3 * subSize], twiddles[3 * k * stride]);
+
+            // Rotating the odd difference by -i (forward) or i (inverse) completes the quarter-turn twiddles.
+            std::complex<float> evenSum = a0 + a2;
+            std::complex<float> evenDifference = a0 - a2;
+            std::complex<float> oddSum = a1 + a3;
+            std::complex<float> oddDifference = a1 - a3;
+            std::complex<float> rotated = direction == FftDirection::Forward
+                ? std::complex<float>(oddDifference.imag(), -oddDifference.real())
+                : std::complex<float>(-oddDifference.imag(), oddDifference.real());
+
+            output[k] = evenSum + oddSum;
+            output[k + subSize] = evenDifference + rotated;
+            output[k + 2 * subSize] = evenSum - oddSum;
+            output[k + 3 * subSize] = evenDifference - rotated;
+        }
+
+        return;
+    }
+
+    // Radix 3 and 5 use a direct DFT across the runs. twiddles[size / radix] is the radix-point root of unity.
+    std::complex<float> scratch[5];
+    unsigned int rootStep = subSize * stride;
+    for (unsigned int k = 0; k < subSize; k++)
+    {
+        for (unsigned int q = 0; q < radix; q++)
+        {
+            scratch[q] = Multiply(output[k + q * subSize], twiddles[q * k * stride]);
+        }
+
+        for (unsigned int outputIndex = 0; outputIndex < radix; outputIndex++)
+        {
+            std::complex<float> sum = scratch[0];
+            for (unsigned int q = 1; q < radix; q++)
+            {
+                sum += Multiply(scratch[q], twiddles[((q * outputIndex) % radix) * rootStep]);
+            }
+
+            output[k + outputIndex * subSize] = sum;
+        }
+    }
+}
+
+void FftPlan::TransformBluestein(const std::complex<float>* input, std::complex<float>* output) const
+{
+    // X[k] = chirp[k] * sum(x[n] * chirp[n] * conj(chirp[k - n])), the sum being a convolution done with power-of-2 FFTs.
+    std::vector<std::complex<float>> weighted(convolutionSize);
+    std::vector<std::complex<float>> spectrum(convolutionSize);
+    for (unsigned int n = 0; n < size; n++)
+    {
+        weighted[n] = Multiply(input[n], chirp[n]);
+    }
+
+    convolutionForward->Execute(weighted.data(), spectrum.data());
+    for (unsigned int i = 0; i < convolutionSize; i++)
+    {
+        spectrum[i] = Multiply(spectrum[i], kernelSpectrum[i]);
+    }
+
+    convolutionInverse->Execute(spectrum.data(), weighted.data());
+    for (unsigned int k = 0; k < size; k++)
+    {
+        output[k] = Multiply(weighted[k], chirp[k]);
+    }
+}
+
+void FftPlan::Execute(const std::complex<float>* input, std::complex<float>* output) const
+{
+    if (useBluestein)
+    {
+        TransformBluestein(input, output);
+    }
+    else if (size == 1)
+    {
+        output[0] = input[0];
+    }
+    else
+    {
+        TransformMixedRadix(output, input, 1, 0);
+    }
+}
+
+std::shared_ptr<const FftPlan> FftPlan::Get(unsigned int size, FftDirection direction)
+{
+    std::pair<unsigned int, FftDirection> key(size, direction);
+
+    cacheLock.lock();
+    auto existingPlan = cache.find(key);
+    if (existingPlan != cache.end())
+    {
+        std::shared_ptr<const FftPlan> plan = existingPlan->second;
+        cacheLock.unlock();
+        return plan;
+    }
+
+    cacheLock.unlock();
+
+    // Plan without the lock held, as Bluestein plans request their own sub-plans. If another thread planned the
+    //  same size in the meantime, its plan is kept so every caller shares one.
+    std::shared_ptr<const FftPlan> newPlan = std::make_shared<const FftPlan>(size, direction);
+
+    cacheLock.lock();
+    std::shared_ptr<const FftPlan> plan = cache.insert(std::make_pair(key, newPlan)).first->second;
+    cacheLock.unlock();
+    return plan;
+}
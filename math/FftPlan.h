@@ -0,0 +1,57 @@
+#pragma once
+#include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+enum class FftDirection
+{
+    Forward,
+
+    // Inverse transforms are unscaled, so a forward then inverse transform multiplies the input by the size.
+    Inverse
+};
+
+// Precomputed FFT of a single size and direction.
+// Sizes whose only prime factors are 2, 3 and 5 use a mixed-radix transform; any other size uses Bluestein's algorithm.
+class FftPlan
+{
+    static std::mutex cacheLock;
+    static std::map<std::pair<unsigned int, FftDirection>, std::shared_ptr<const FftPlan>> cache;
+
+    unsigned int size;
+    FftDirection direction;
+
+    // Mixed-radix factors, in the order they are applied, and the e^(-+2 PI i k / size) twiddles they share.
+    std::vector<unsigned int> factors;
+    std::vector<std::complex<float>> twiddles;
+
+    // Bluestein state: the chirp, the transformed convolution kernel, and the power-of-2 plans used for the convolution.
+    bool useBluestein;
+    unsigned int convolutionSize;
+    std::vector<std::complex<float>> chirp;
+    std::vector<std::complex<float>> kernelSpectrum;
+    std::shared_ptr<const FftPlan> convolutionForward;
+    std::shared_ptr<const FftPlan> convolutionInverse;
+
+    void TransformMixedRadix(std::complex<float>* output, const std::complex<float>* input, unsigned int stride, unsigned int factorIndex) const;
+    void TransformBluestein(const std::complex<float>* input, std::complex<float>* output) const;
+
+public:
+    FftPlan(unsigned int size, FftDirection direction);
+
+    unsigned int GetSize() const;
+    FftDirection GetDirection() const;
+
+    // True if this size is computed with Bluestein's algorithm, which costs roughly three power-of-2 FFTs of at least twice the size.
+    bool UsesBluestein() const;
+
+    // Transforms the input into the output, which must both hold GetSize() samples and must not overlap.
+    // Plans are immutable once created, so can execute on several threads at once.
+    void Execute(const std::complex<float>* input, std::complex<float>* output) const;
+
+    // Returns the cached plan for this size and direction, creating it the first time it is requested. Thread-safe.
+    static std::shared_ptr<const FftPlan> Get(unsigned int size, FftDirection direction);
+};
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "FixedPoint.h"
+
+#if defined(__ARM_NEON) || defined(_M_ARM) || defined(_M_ARM64)
+#define FIXED_POINT_NEON
+#include <arm_neon.h>
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define FIXED_POINT_SSE2
+#include <emmintrin.h>
+#endif
+
+short FixedPoint::ToQ15(float value)
+{
+    return Saturate((int)std::floor(value * 32768.0f + 0.5f));
+}
+
+short FixedPoint::Saturate(int value)
+{
+    return (short)std::max(-32768, std::min(32767, value));
+}
+
+FixedPointKernel FixedPoint::CreateKernel(const std::vector<float>& kernel)
+{
+    FixedPointKernel fixedPointKernel;
+
+    std::size_t paddedLength = (kernel.size() + 3) & ~(std::size_t)3;
+    fixedPointKernel.taps.resize(paddedLength, 0);
+    for (std::size_t i = 0; i < kernel.size(); i++)
+    {
+        fixedPointKernel.taps[i] = ToQ15(kernel[i]);
+    }
+
+    const std::vector<short>& taps = fixedPointKernel.taps;
+    fixedPointKernel.interleavedTaps.reserve(paddedLength * 2);
+    for (std::size_t i = 0; i < paddedLength; i += 4)
+    {
+        short groupLayout[8] = { taps[i], taps[i + 1], taps[i], taps[i + 1], taps[i + 2], taps[i + 3], taps[i + 2], taps[i + 3] };
+        fixedPointKernel.interleavedTaps.insert(fixedPointKernel.interleavedTaps.end(), groupLayout, groupLayout + 8);
+    }
+
+    return fixedPointKernel;
+}
+
+void FixedPoint::Decimate(SampleView<const ComplexInt16> samples, const FixedPointKernel& kernel, unsigned int decimationFactor, SampleBlock<ComplexInt16>& output)
+{
+    output.Clear();
+    std::size_t kernelLength = kernel.taps.size();
+    for (std::size_t n = 0; n + kernelLength <= samples.size(); n += decimationFactor)
+    {
+        const ComplexInt16* input = samples.data() + n;
+        int sumI = 0;
+        int sumQ = 0;
+
+#if defined(FIXED_POINT_SSE2)
+        // Shuffle each (I0, Q0, I1, Q1) into (I0, I1, Q0, Q1) so one multiply-add sums two taps of I, and two of Q.
+        __m128i sums = _mm_setzero_si128();
+        for (std::size_t m = 0; m < kernelLength; m += 4)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + m));
+            values = _mm_shufflelo_epi16(values, _MM_SHUFFLE(3, 1, 2, 0));
+            values = _mm_shufflehi_epi16(values, _MM_SHUFFLE(3, 1, 2, 0));
+
+            __m128i taps = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&kernel.interleavedTaps[m * 2]));
+            sums = _mm_add_epi32(sums, _mm_madd_epi16(values, taps));
+        }
+
+        int laneSums[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(laneSums), sums);
+        sumI = laneSums[0] + laneSums[2];
+        sumQ = laneSums[1] + laneSums[3];
+#elif defined(FIXED_POINT_NEON)
+        // Load de-interleaves I and Q, so each can multiply-accumulate against the taps directly.
+        int32x4_t sumsI = vdupq_n_s32(0);
+        int32x4_t sumsQ = vdupq_n_s32(0);
+        for (std::size_t m = 0; m < kernelLength; m += 4)
+        {
+            int16x4x2_t values = vld2_s16(reinterpret_cast<const int16_t*>(input + m));
+            int16x4_t taps = vld1_s16(&kernel.taps[m]);
+            sumsI = vmlal_s16(sumsI, values.val[0], taps);
+            sumsQ = vmlal_s16(sumsQ, values.val[1], taps);
+        }
+
+        int laneSums[4];
+        vst1q_s32(laneSums, sumsI);
+        sumI = laneSums[0] + laneSums[1] + laneSums[2] + laneSums[3];
+        vst1q_s32(laneSums, sumsQ);
+        sumQ = laneSums[0] + laneSums[1] + laneSums[2] + laneSums[3];
+#else
+        for (std::size_t m = 0; m < kernelLength; m++)
+        {
+            sumI += (int)input[m].i * kernel.taps[m];
+            sumQ += (int)input[m].q * kernel.taps[m];
+        }
+#endif
+
+        // Round back to Q15.
+        ComplexInt16 result;
+        result.i = Saturate((sumI + (1 << 14)) >> 15);
+        result.q = Saturate((sumQ + (1 << 14)) >> 15);
+        output.PushBack(result);
+    }
+}
+
+short FixedPoint::Atan2(int y, int x)
+{
+    if (x == 0 && y == 0)
+    {
+        return 0;
+    }
+
+    // Within the first octant, atan(z) / PI ~= z / 4 + 0.0869 * z * (1 - z), for z = min / max in [0, 1].
+    long long absX = std::llabs((long long)x);
+    long long absY = std::llabs((long long)y);
+    int ratio = (int)((std::min(absX, absY) << 15) / std::max(absX, absY));
+    int angle = (ratio >> 2) + ((2847 * ((ratio * (32768 - ratio)) >> 15)) >> 15);
+
+    // Unfold the octant into the full circle.
+    if (absY > absX)
+    {
+        angle = 16384 - angle;
+    }
+
+    if (x < 0)
+    {
+        angle = 32768 - angle;
+    }
+
+    if (y < 0)
+    {
+        angle = -angle;
+    }
+
+    return Saturate(angle);
+}
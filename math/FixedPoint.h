@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include "SampleBlock.h"
+
+// Selects between floating-point and Q15 (1.15 fixed-point) implementations of DSP stages at runtime.
+enum class DspPrecision
+{
+    Float,
+    FixedPoint
+};
+
+// Q15 FIR kernel, padded to a multiple of 4 taps, with a copy laid out for SSE2 multiply-adds.
+struct FixedPointKernel
+{
+    std::vector<short> taps;
+
+    // Each group of 4 taps (k0, k1, k2, k3) stored as (k0, k1, k0, k1, k2, k3, k2, k3), to match de-interleaved I/Q pairs.
+    std::vector<short> interleavedTaps;
+};
+
+// Saturating Q15 arithmetic and fixed-point DSP kernels, using SSE2 or NEON where available.
+class FixedPoint
+{
+public:
+    // Converts a float in [-1, 1) to Q15, saturating out-of-range values.
+    static short ToQ15(float value);
+
+    // Clamps a 32-bit intermediate into the 16-bit range.
+    static short Saturate(int value);
+
+    static FixedPointKernel CreateKernel(const std::vector<float>& kernel);
+
+    // Convolves the kernel across the samples, producing one output for every decimationFactor inputs.
+    // Outputs that would need samples past the end of the input are not produced.
+    static void Decimate(SampleView<const ComplexInt16> samples, const FixedPointKernel& kernel, unsigned int decimationFactor, SampleBlock<ComplexInt16>& output);
+
+    // Returns atan2(y, x) / PI in Q15, accurate to about 0.3 degrees.
+    static short Atan2(int y, int x);
+};
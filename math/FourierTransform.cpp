@@ -1,111 +1,176 @@
+#include <algorithm>
+#include <cmath>
 #include "math\Constants.h"
+#include "CustomFilter.h"
 #include "FourierTransform.h"
 
-unsigned int FourierTransform::log2(unsigned int x)
+std::vector<float> FourierTransform::DesignLowPass(float passFrequency, float stopFrequency)
 {
-    int result = 0;
-    while (x != 0)
+    // A Blackman window's transition band is about 6 / length wide.
+    unsigned int length = (unsigned int)std::ceil(6.0f / std::max(stopFrequency - passFrequency, 1e-3f)) | 1;
+    float cutoffFrequency = (passFrequency + stopFrequency) / 2.0f;
+
+    std::vector<float> kernel(length);
+    float sum = 0.0f;
+    for (unsigned int i = 0; i < length; i++)
     {
-        x >>= 1;
-        ++result;
+        int offset = (int)i - (int)(length / 2);
+        float sinc = offset == 0 ? 2.0f * Constants::PI * cutoffFrequency : std::sin(2.0f * Constants::PI * cutoffFrequency * (float)offset) / (float)offset;
+        kernel[i] = sinc * CustomFilter::ComputeBlackmanWindowPt(i, length - 1);
+        sum += kernel[i];
     }
 
-    return result;
-}
-
-unsigned int FourierTransform::reverseBits(unsigned int x, unsigned int maxValue)
-{
-    unsigned int maxShiftRange = log2(maxValue) - 1;
-    unsigned int result = 0;
-    for (unsigned int i = 0; i < maxShiftRange; i++)
+    for (unsigned int i = 0; i < length; i++)
     {
-        unsigned int mask = 1 << i;
-        if ((x & mask) != 0)
-        {
-            result |= 1 << (maxShiftRange - (i + 1));
-        }
+        kernel[i] /= sum;
     }
 
-    return result;
+    return kernel;
 }
 
-bool FourierTransform::ComplexDFT(std::vector<unsigned char> samples, std::vector<float>& reals, std::vector<float>& imags)
+bool FourierTransform::ComputeChirpZ(SampleView<const std::complex<float>> samples, float startFrequency, float stopFrequency, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags)
 {
-    unsigned int length = samples.size() / 2;
+    unsigned int length = (unsigned int)samples.size();
+    if (length == 0 || bins == 0)
+    {
+        Logger::Log("Could not perform the chirp-z transform of ", length, " samples into ", bins, " bins.");
+        return false;
+    }
 
-    // Prepare our output arrays
-    reals.clear();
-    reals.resize(length, 0);
+    unsigned int convolutionLength = 1;
+    while (convolutionLength < length + bins - 1)
+    {
+        convolutionLength <<= 1;
+    }
 
-    imags.clear();
-    imags.resize(length, 0);
+    // X[k] = W^(k^2 / 2) * sum(x[n] * A^-n * W^(n^2 / 2) * W^(-(k - n)^2 / 2)), for A = e^(2 PI i start) and W = e^(-2 PI i step).
+    // The phases grow with n^2, so are wrapped in double precision before converting to float.
+    const double twoPi = 6.283185307179586;
+    double step = ((double)stopFrequency - (double)startFrequency) / (double)bins;
+    auto chirp = [=](double n)
+    {
+        double cycles = 0.5 * step * n * n;
+        return std::polar(1.0f, (float)(-twoPi * (cycles - std::floor(cycles))));
+    };
 
-    for (unsigned int i = 0; i < length; i++)
+    SampleBlock<std::complex<float>> weightedSamples(convolutionLength);
+    for (unsigned int n = 0; n < length; n++)
+    {
+        double cycles = (double)startFrequency * (double)n;
+        weightedSamples[n] = samples[n] * std::polar(1.0f, (float)(-twoPi * (cycles - std::floor(cycles)))) * chirp(n);
+    }
+
+    // The convolution kernel covers offsets from -(length - 1) to (bins - 1), with negative offsets wrapped around the end.
+    SampleBlock<std::complex<float>> chirpKernel(convolutionLength);
+    for (unsigned int m = 0; m < std::max(length, bins); m++)
     {
-        for (unsigned int j = 0; j < length; j++)
+        std::complex<float> value = std::conj(chirp(m));
+        if (m < bins)
+        {
+            chirpKernel[m] = value;
+        }
+
+        if (m != 0 && m < length)
         {
-            float angularFrequency = 2.0f * Constants::PI * (float)i * (float)j / (float)length;
-            float realCosine = std::cos(angularFrequency);
-            float imagSine = -std::sin(angularFrequency);
-            reals[i] += samples[j * 2] * realCosine - samples[j * 2 + 1] * imagSine;
-            imags[i] += samples[j * 2] * imagSine   + samples[j * 2 + 1] * realCosine;
+            chirpKernel[convolutionLength - m] = value;
         }
     }
 
-    return true;
-}
+    std::vector<float> sampleReals;
+    std::vector<float> sampleImags;
+    std::vector<float> kernelReals;
+    std::vector<float> kernelImags;
+    ComplexFFT(weightedSamples.View(), sampleReals, sampleImags);
+    ComplexFFT(chirpKernel.View(), kernelReals, kernelImags);
 
-bool FourierTransform::ComplexFFT(std::vector<unsigned char> samples, std::vector<float>& reals, std::vector<float>& imags)
-{
-    unsigned int length = samples.size() / 2;
-    if (length == 0 || (length & (length - 1)) != 0)
+    // Multiply the spectra, then inverse transform by conjugating before and after a forward transform.
+    for (unsigned int i = 0; i < convolutionLength; i++)
     {
-        Logger::Log("Could not perform the complex FFT on a non-power of 2 sample length: ", samples.size());
-        return false;
+        std::complex<float> product = std::complex<float>(sampleReals[i], sampleImags[i]) * std::complex<float>(kernelReals[i], kernelImags[i]);
+        weightedSamples[i] = std::conj(product);
     }
 
-    // Interlace our data.
-    reals.clear();
-    reals.reserve(length);
+    ComplexFFT(weightedSamples.View(), sampleReals, sampleImags);
 
-    imags.clear();
-    imags.reserve(length);
+    reals.resize(bins);
+    imags.resize(bins);
+    float scale = 1.0f / (float)convolutionLength;
+    for (unsigned int k = 0; k < bins; k++)
+    {
+        std::complex<float> value = chirp(k) * std::complex<float>(sampleReals[k], -sampleImags[k]) * scale;
+        reals[k] = value.real();
+        imags[k] = value.imag();
+    }
 
-    for (unsigned int i = 0; i < length; i++)
+    return true;
+}
+
+bool FourierTransform::ComputeZoomSpectrum(SampleBlock<std::complex<float>>& samples, float centerFrequency, float span, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags)
+{
+    span = std::min(std::max(span, 1e-6f), 1.0f);
+
+    // Mix the center of the span down to DC. The oscillator is resynchronized periodically so rounding doesn't accumulate.
+    const double twoPi = 6.283185307179586;
+    std::complex<float> rotation = std::polar(1.0f, (float)(-twoPi * centerFrequency));
+    std::complex<float> oscillator;
+    for (std::size_t i = 0; i < samples.size(); i++)
     {
-        unsigned int idxToCopyFrom = FourierTransform::reverseBits(i, length);
+        if (i % 1024 == 0)
+        {
+            double cycles = (double)centerFrequency * (double)i;
+            oscillator = std::polar(1.0f, (float)(-twoPi * (cycles - std::floor(cycles))));
+        }
 
-        reals.push_back((float)samples[idxToCopyFrom * 2]);
-        imags.push_back((float)samples[idxToCopyFrom * 2 + 1]);
+        samples[i] *= oscillator;
+        oscillator *= rotation;
     }
 
-    int levels = FourierTransform::log2(length);
-    for (int level = 0; level < levels; level++)
+    // Halve the sample rate while it still covers the span with a 25% margin. Only frequencies that would alias into the span
+    //  need to be removed, so the early stages, where the span is narrow relative to the rate, need very few taps.
+    float rate = 1.0f;
+    SampleBlock<std::complex<float>> decimatedSamples;
+    while (rate / 2.0f >= span * 1.25f)
     {
-        int subDftSize = (int)std::pow(2, level); // Go from small DFT to large DFT
-        float ur = 1;
-        float ui = 0;
-        float sr = std::cos(Constants::PI / (float)subDftSize);
-        float si = -std::sin(Constants::PI / (float)subDftSize);
-        for (int j = 1; j < subDftSize; j++) // Iterate over the size of a DFT, skipping the first point
+        float passFrequency = (span / 2.0f) / rate;
+        std::vector<float> kernel = DesignLowPass(passFrequency, 0.5f - passFrequency);
+        if (samples.size() < kernel.size() * 4)
+        {
+            break;
+        }
+
+        decimatedSamples.Clear();
+        for (std::size_t n = 0; n + kernel.size() <= samples.size(); n += 2)
         {
-            for (int i = j - 1; i <= (int)length - subDftSize; i += subDftSize*2) // Iterate over the entire data set, skipping the first point and iterating per DFT size
+            std::complex<float> sum(0.0f, 0.0f);
+            for (std::size_t m = 0; m < kernel.size(); m++)
             {
-                int ip = i + subDftSize;
-                
-                // X [ip] = (x[i] - x[ip]) * U, swap/add also
-                float tr = reals[ip] * ur - imags[ip] * ui;
-                float ti = reals[ip] * ui + imags[ip] * ur;
-                reals[ip] = reals[i] - tr;
-                imags[ip] = imags[i] - ti;
-                reals[i] += tr;
-                imags[i] += ti;
+                sum += samples[n + m] * kernel[m];
             }
 
-            // U = U * S (complex mult)
-            ur = ur * sr - ui * si;
-            ui = ur * si + ui * sr;
+            decimatedSamples.PushBack(sum);
         }
+
+        std::swap(samples, decimatedSamples);
+        rate /= 2.0f;
+    }
+
+    float windowSum = 0.0f;
+    for (std::size_t i = 0; i < samples.size(); i++)
+    {
+        float windowValue = CustomFilter::ComputeBlackmanWindowPt((int)i, (int)samples.size());
+        samples[i] *= windowValue;
+        windowSum += windowValue;
+    }
+
+    if (!ComputeChirpZ(samples.View(), -(span / 2.0f) / rate, (span / 2.0f) / rate, bins, reals, imags))
+    {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < bins; i++)
+    {
+        reals[i] /= windowSum;
+        imags[i] /= windowSum;
     }
 
     return true;
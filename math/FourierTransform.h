@@ -1,20 +1,121 @@
 #pragma once
+#include <complex>
 #include <vector>
 #include "logging\Logger.h"
+#include "Constants.h"
+#include "FftPlan.h"
+#include "SampleBlock.h"
 
 // Performs the Fourier Transform for a variety of inputs.
 class FourierTransform
 {
-    static unsigned int log2(unsigned int x);
+    // Designs a Blackman-windowed sinc low-pass filter with the provided pass and stop band edges, as fractions of the sample rate.
+    static std::vector<float> DesignLowPass(float passFrequency, float stopFrequency);
 
-    static unsigned int FourierTransform::reverseBits(unsigned int x, unsigned int maxValue);
+    static bool ComputeChirpZ(SampleView<const std::complex<float>> samples, float startFrequency, float stopFrequency, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags);
+    static bool ComputeZoomSpectrum(SampleBlock<std::complex<float>>& samples, float centerFrequency, float span, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags);
 
 public:
     // Performs the Complex DFT on a series of inputs, returning a vector of reals and imaginaries.
     // This should be identical to the FFT, but run more slowly.
-    static bool ComplexDFT(std::vector<unsigned char> samples, std::vector<float>& reals, std::vector<float>& imags);
+    template<typename T>
+    static bool ComplexDFT(SampleView<T> samples, std::vector<float>& reals, std::vector<float>& imags);
 
     // Performs the Complex FFT on a series of inputs, returning a vector of reals and imaginaries.
-    static bool ComplexFFT(std::vector<unsigned char> samples, std::vector<float>& reals, std::vector<float>& imags);
+    // Any length is supported through a cached FftPlan, though lengths with prime factors other than 2, 3 and 5 are several times slower.
+    template<typename T>
+    static bool ComplexFFT(SampleView<T> samples, std::vector<float>& reals, std::vector<float>& imags);
+
+    // Computes bins evenly spaced from the start frequency up to the stop frequency (exclusive), as fractions of the sample rate in [-0.5, 0.5].
+    // Uses Bluestein's chirp-z algorithm, so any number of bins and any span can be computed with power-of-2 FFTs.
+    template<typename T>
+    static bool ChirpZ(SampleView<T> samples, float startFrequency, float stopFrequency, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags);
+
+    // Computes bins across a span centered on a frequency, both as fractions of the sample rate. The output is windowed,
+    //  and scaled so a full-scale tone has a magnitude of 1. The span is mixed to DC and decimated before the chirp-z transform,
+    //  so narrow spans cost a small fraction of a full-bandwidth FFT with the same resolution.
+    template<typename T>
+    static bool ZoomSpectrum(SampleView<T> samples, float centerFrequency, float span, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags);
 };
 
+template<typename T>
+bool FourierTransform::ComplexDFT(SampleView<T> samples, std::vector<float>& reals, std::vector<float>& imags)
+{
+    unsigned int length = (unsigned int)samples.size();
+
+    // Prepare our output arrays
+    reals.clear();
+    reals.resize(length, 0);
+
+    imags.clear();
+    imags.resize(length, 0);
+
+    for (unsigned int i = 0; i < length; i++)
+    {
+        for (unsigned int j = 0; j < length; j++)
+        {
+            std::complex<float> sample = SampleTraits<T>::ToComplexFloat(samples[j]);
+            float angularFrequency = 2.0f * Constants::PI * (float)i * (float)j / (float)length;
+            float realCosine = std::cos(angularFrequency);
+            float imagSine = -std::sin(angularFrequency);
+            reals[i] += sample.real() * realCosine - sample.imag() * imagSine;
+            imags[i] += sample.real() * imagSine   + sample.imag() * realCosine;
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+bool FourierTransform::ComplexFFT(SampleView<T> samples, std::vector<float>& reals, std::vector<float>& imags)
+{
+    unsigned int length = (unsigned int)samples.size();
+    if (length == 0)
+    {
+        Logger::Log("Could not perform the complex FFT on an empty sample block.");
+        return false;
+    }
+
+    SampleBlock<std::complex<float>> convertedSamples(length);
+    for (unsigned int i = 0; i < length; i++)
+    {
+        convertedSamples[i] = SampleTraits<T>::ToComplexFloat(samples[i]);
+    }
+
+    SampleBlock<std::complex<float>> spectrum(length);
+    FftPlan::Get(length, FftDirection::Forward)->Execute(convertedSamples.data(), spectrum.data());
+
+    reals.resize(length);
+    imags.resize(length);
+    for (unsigned int i = 0; i < length; i++)
+    {
+        reals[i] = spectrum[i].real();
+        imags[i] = spectrum[i].imag();
+    }
+
+    return true;
+}
+
+template<typename T>
+bool FourierTransform::ChirpZ(SampleView<T> samples, float startFrequency, float stopFrequency, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags)
+{
+    SampleBlock<std::complex<float>> convertedSamples(samples.size());
+    for (std::size_t i = 0; i < samples.size(); i++)
+    {
+        convertedSamples[i] = SampleTraits<T>::ToComplexFloat(samples[i]);
+    }
+
+    return ComputeChirpZ(convertedSamples.View(), startFrequency, stopFrequency, bins, reals, imags);
+}
+
+template<typename T>
+bool FourierTransform::ZoomSpectrum(SampleView<T> samples, float centerFrequency, float span, unsigned int bins, std::vector<float>& reals, std::vector<float>& imags)
+{
+    SampleBlock<std::complex<float>> convertedSamples(samples.size());
+    for (std::size_t i = 0; i < samples.size(); i++)
+    {
+        convertedSamples[i] = SampleTraits<T>::ToComplexFloat(samples[i]);
+    }
+
+    return ComputeZoomSpectrum(convertedSamples, centerFrequency, span, bins, reals, imags);
+}
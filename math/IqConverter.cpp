@@ -0,0 +1,164 @@
+#include "IqConverter.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define IQ_CONVERTER_SSE2
+#include <emmintrin.h>
+#endif
+
+float IqConverter::lookupTable[256];
+bool IqConverter::lookupTableInitialized = false;
+
+void IqConverter::InitializeLookupTable()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        lookupTable[i] = ((float)i - 127.5f) / 127.5f;
+    }
+
+    lookupTableInitialized = true;
+}
+
+IqConverter::IqConverter()
+    : dcOffsetI(0.0f), dcOffsetQ(0.0f)
+{
+    if (!lookupTableInitialized)
+    {
+        InitializeLookupTable();
+    }
+}
+
+void IqConverter::UpdateDcOffset(float sumI, float sumQ, unsigned int samples)
+{
+    if (samples == 0)
+    {
+        return;
+    }
+
+    // The sums are of DC-corrected samples, so their mean is the remaining error in our estimate.
+    dcOffsetI += dcTrackingRate * (sumI / (float)samples);
+    dcOffsetQ += dcTrackingRate * (sumQ / (float)samples);
+}
+
+void IqConverter::Convert(SampleView<const IqByte> iqSamples, SampleView<std::complex<float>> output)
+{
+    // Both types are tightly-packed pairs, so the conversion operates on the underlying values.
+    const unsigned char* samples = reinterpret_cast<const unsigned char*>(iqSamples.data());
+    unsigned int byteCount = (unsigned int)iqSamples.size() * 2;
+    float* outputValues = reinterpret_cast<float*>(output.data());
+    float sumI = 0.0f;
+    float sumQ = 0.0f;
+
+    unsigned int i = 0;
+#ifdef IQ_CONVERTER_SSE2
+    // output = byte / 127.5 - (1 + dcOffset), with I and Q alternating within each register.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(1.0f / 127.5f);
+    const __m128 offset = _mm_setr_ps(1.0f + dcOffsetI, 1.0f + dcOffsetQ, 1.0f + dcOffsetI, 1.0f + dcOffsetQ);
+    __m128 sums = _mm_setzero_ps();
+    for (; i + 16 <= byteCount; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        __m128i lowWords = _mm_unpacklo_epi8(bytes, zero);
+        __m128i highWords = _mm_unpackhi_epi8(bytes, zero);
+
+        __m128 values0 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lowWords, zero)), scale), offset);
+        __m128 values1 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lowWords, zero)), scale), offset);
+        __m128 values2 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(highWords, zero)), scale), offset);
+        __m128 values3 = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(highWords, zero)), scale), offset);
+
+        _mm_storeu_ps(outputValues + i, values0);
+        _mm_storeu_ps(outputValues + i + 4, values1);
+        _mm_storeu_ps(outputValues + i + 8, values2);
+        _mm_storeu_ps(outputValues + i + 12, values3);
+
+        sums = _mm_add_ps(sums, _mm_add_ps(_mm_add_ps(values0, values1), _mm_add_ps(values2, values3)));
+    }
+
+    float laneSums[4];
+    _mm_storeu_ps(laneSums, sums);
+    sumI = laneSums[0] + laneSums[2];
+    sumQ = laneSums[1] + laneSums[3];
+#endif
+
+    // Convert anything SIMD couldn't through the lookup table.
+    for (; i + 1 < byteCount; i += 2)
+    {
+        outputValues[i] = lookupTable[samples[i]] - dcOffsetI;
+        outputValues[i + 1] = lookupTable[samples[i + 1]] - dcOffsetQ;
+        sumI += outputValues[i];
+        sumQ += outputValues[i + 1];
+    }
+
+    UpdateDcOffset(sumI, sumQ, byteCount / 2);
+}
+
+void IqConverter::ConvertToInt16(SampleView<const IqByte> iqSamples, SampleView<ComplexInt16> outputSamples)
+{
+    const unsigned char* samples = reinterpret_cast<const unsigned char*>(iqSamples.data());
+    unsigned int byteCount = (unsigned int)iqSamples.size() * 2;
+    short* output = reinterpret_cast<short*>(outputSamples.data());
+
+    // Q15 values are (byte - 128) * 256, less the DC offset scaled to Q15.
+    short offsetI = (short)(dcOffsetI * 32768.0f);
+    short offsetQ = (short)(dcOffsetQ * 32768.0f);
+    double sumI = 0.0;
+    double sumQ = 0.0;
+
+    unsigned int i = 0;
+#ifdef IQ_CONVERTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i center = _mm_set1_epi16(128);
+    const __m128i offset = _mm_setr_epi16(offsetI, offsetQ, offsetI, offsetQ, offsetI, offsetQ, offsetI, offsetQ);
+
+    // Multiplying by (1, 0) and (0, 1) pairs sums the I and Q lanes into 32-bit accumulators.
+    const __m128i selectI = _mm_set1_epi32(1);
+    const __m128i selectQ = _mm_set1_epi32(1 << 16);
+    __m128i sumsI = _mm_setzero_si128();
+    __m128i sumsQ = _mm_setzero_si128();
+    unsigned int iterationsSinceFlush = 0;
+    for (; i + 16 <= byteCount; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        __m128i lowWords = _mm_subs_epi16(_mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(bytes, zero), center), 8), offset);
+        __m128i highWords = _mm_subs_epi16(_mm_slli_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(bytes, zero), center), 8), offset);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), lowWords);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 8), highWords);
+
+        sumsI = _mm_add_epi32(sumsI, _mm_add_epi32(_mm_madd_epi16(lowWords, selectI), _mm_madd_epi16(highWords, selectI)));
+        sumsQ = _mm_add_epi32(sumsQ, _mm_add_epi32(_mm_madd_epi16(lowWords, selectQ), _mm_madd_epi16(highWords, selectQ)));
+
+        // Flush before the 32-bit accumulators could overflow.
+        if (++iterationsSinceFlush == 4096 || i + 32 > byteCount)
+        {
+            int laneSums[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(laneSums), sumsI);
+            sumI += (double)laneSums[0] + laneSums[1] + laneSums[2] + laneSums[3];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(laneSums), sumsQ);
+            sumQ += (double)laneSums[0] + laneSums[1] + laneSums[2] + laneSums[3];
+
+            sumsI = _mm_setzero_si128();
+            sumsQ = _mm_setzero_si128();
+            iterationsSinceFlush = 0;
+        }
+    }
+#endif
+
+    for (; i + 1 < byteCount; i += 2)
+    {
+        int valueI = (((int)samples[i] - 128) << 8) - offsetI;
+        int valueQ = (((int)samples[i + 1] - 128) << 8) - offsetQ;
+        output[i] = (short)std::max(-32768, std::min(32767, valueI));
+        output[i + 1] = (short)std::max(-32768, std::min(32767, valueQ));
+        sumI += output[i];
+        sumQ += output[i + 1];
+    }
+
+    UpdateDcOffset((float)(sumI / 32768.0), (float)(sumQ / 32768.0), byteCount / 2);
+}
+
+void IqConverter::ResetDcOffset()
+{
+    dcOffsetI = 0.0f;
+    dcOffsetQ = 0.0f;
+}
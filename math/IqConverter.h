@@ -0,0 +1,34 @@
+#pragma once
+#include <complex>
+#include "SampleBlock.h"
+
+// Converts raw unsigned 8-bit I/Q samples from the SDR into complex floats (or 16-bit integers), removing the DC offset.
+// The DC offset is tracked across blocks, so a single converter should be used per sample stream.
+class IqConverter
+{
+    // Maps a raw byte directly onto its normalized value, for platforms without SSE2 and for block tails.
+    static float lookupTable[256];
+    static bool lookupTableInitialized;
+    static void InitializeLookupTable();
+
+    // How quickly the DC offset estimate follows the per-block mean.
+    const float dcTrackingRate = 0.1f;
+
+    // Current DC offset estimate, in normalized units.
+    float dcOffsetI;
+    float dcOffsetQ;
+
+    void UpdateDcOffset(float sumI, float sumQ, unsigned int samples);
+
+public:
+    IqConverter();
+
+    // Converts raw I/Q bytes into complex floats normalized to [-1, 1]. The output must be at least as large as the input.
+    void Convert(SampleView<const IqByte> samples, SampleView<std::complex<float>> output);
+
+    // Converts raw I/Q bytes into Q15 (1.15 fixed-point) complex values. The output must be at least as large as the input.
+    void ConvertToInt16(SampleView<const IqByte> samples, SampleView<ComplexInt16> output);
+
+    // Forgets the DC offset estimate, for when the tuning changes.
+    void ResetDcOffset();
+};
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+#include "logging\Logger.h"
+#include "LargeFourierTransform.h"
+
+LargeFourierTransform::LargeFourierTransform(unsigned int size, unsigned int threadCount)
+    : size(std::max(size, 1u)), threadCount(1), rows(1), columns(1), rowPlan(), columnPlan(),
+      coarseTwiddles(), fineTwiddles(), firstWorkspace(std::max(size, 1u)), secondWorkspace(std::max(size, 1u))
+{
+    SetThreadCount(threadCount);
+
+    for (unsigned int divisor = 1; (unsigned long long)divisor * divisor <= this->size; divisor++)
+    {
+        if (this->size % divisor == 0)
+        {
+            rows = divisor;
+        }
+    }
+
+    columns = this->size / rows;
+    rowPlan = FftPlan::Get(columns, FftDirection::Forward);
+    columnPlan = FftPlan::Get(rows, FftDirection::Forward);
+
+    const double twoPi = 6.283185307179586;
+    coarseTwiddles.resize(rows);
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        coarseTwiddles[i] = std::polar(1.0f, (float)(-twoPi * (double)i * (double)columns / (double)this->size));
+    }
+
+    fineTwiddles.resize(columns);
+    for (unsigned int i = 0; i < columns; i++)
+    {
+        fineTwiddles[i] = std::polar(1.0f, (float)(-twoPi * (double)i / (double)this->size));
+    }
+}
+
+unsigned int LargeFourierTransform::GetSize() const
+{
+    return size;
+}
+
+unsigned int LargeFourierTransform::GetThreadCount() const
+{
+    return threadCount;
+}
+
+void LargeFourierTransform::SetThreadCount(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+
+    this->threadCount = std::max(threadCount, 1u);
+}
+
+template<typename Function>
+void LargeFourierTransform::ParallelFor(unsigned int count, Function function) const
+{
+    unsigned int chunkSize = (count + threadCount - 1) / threadCount;
+    std::vector<std::future<void>> tasks;
+    for (unsigned int start = chunkSize; start < count; start += chunkSize)
+    {
+        tasks.push_back(std::async(std::launch::async, function, start, std::min(count, start + chunkSize)));
+    }
+
+    function(0, std::min(count, chunkSize));
+    for (std::future<void>& task : tasks)
+    {
+        task.wait();
+    }
+}
+
+void LargeFourierTransform::Transpose(const std::complex<float>* input, std::complex<float>* output, unsigned int inputRows, unsigned int inputColumns) const
+{
+    // Each thread takes a band of tile rows. Within a tile, reads and writes both stay within a few cache lines per row.
+    unsigned int tileRows = (inputRows + tileSize - 1) / tileSize;
+    ParallelFor(tileRows, [=](unsigned int startTile, unsigned int endTile)
+    {
+        for (unsigned int tileRow = startTile * tileSize; tileRow < std::min(inputRows, endTile * tileSize); tileRow += tileSize)
+        {
+            unsigned int rowEnd = std::min(inputRows, tileRow + tileSize);
+            for (unsigned int tileColumn = 0; tileColumn < inputColumns; tileColumn += tileSize)
+            {
+                unsigned int columnEnd = std::min(inputColumns, tileColumn + tileSize);
+                for (unsigned int row = tileRow; row < rowEnd; row++)
+                {
+                    for (unsigned int column = tileColumn; column < columnEnd; column++)
+                    {
+                        output[(std::size_t)column * inputRows + row] = input[(std::size_t)row * inputColumns + column];
+                    }
+                }
+            }
+        }
+    });
+}
+
+void LargeFourierTransform::TransformRows(const std::complex<float>* input, std::complex<float>* output, unsigned int rowCount, const FftPlan& plan, bool applyTwiddles) const
+{
+    unsigned int rowLength = plan.GetSize();
+    ParallelFor(rowCount, [&](unsigned int startRow, unsigned int endRow)
+    {
+        for (unsigned int row = startRow; row < endRow; row++)
+        {
+            std::complex<float>* rowOutput = output + (std::size_t)row * rowLength;
+            plan.Execute(input + (std::size_t)row * rowLength, rowOutput);
+
+            // Twiddle row n1, column k2 by e^(-2 PI i n1 k2 / size) while the row is still in cache. n1 k2 is below the size,
+            //  and steps by n1 (no more than the columns) per column, so its coarse and fine parts are tracked without dividing.
+            if (applyTwiddles)
+            {
+                unsigned int coarse = 0;
+                unsigned int fine = 0;
+                for (unsigned int column = 0; column < rowLength; column++)
+                {
+                    std::complex<float> twiddle = coarseTwiddles[coarse] * fineTwiddles[fine];
+                    fine += row;
+                    if (fine >= columns)
+                    {
+                        fine -= columns;
+                        ++coarse;
+                    }
+
+                    rowOutput[column] = std::complex<float>(
+                        rowOutput[column].real() * twiddle.real() - rowOutput[column].imag() * twiddle.imag(),
+                        rowOutput[column].real() * twiddle.imag() + rowOutput[column].imag() * twiddle.real());
+                }
+            }
+        }
+    });
+}
+
+bool LargeFourierTransform::Transform(SampleView<const std::complex<float>> samples, SampleBlock<std::complex<float>>& spectrum)
+{
+    if (samples.size() != size)
+    {
+        Logger::LogError("The large FFT expected ", size, " samples, but was given ", samples.size());
+        return false;
+    }
+
+    // Sample n1 + rows * n2 goes to row n1, column n2, so each row holds every rows-th sample.
+    spectrum.Resize(size);
+    Transpose(samples.data(), firstWorkspace.data(), columns, rows);
+
+    // Transform and twiddle each row, then transform each column (as a row, after transposing).
+    TransformRows(firstWorkspace.data(), secondWorkspace.data(), rows, *rowPlan, true);
+    Transpose(secondWorkspace.data(), firstWorkspace.data(), rows, columns);
+    TransformRows(firstWorkspace.data(), secondWorkspace.data(), columns, *columnPlan, false);
+
+    // Bin k2 + columns * k1 is now at row k2, column k1.
+    Transpose(secondWorkspace.data(), spectrum.data(), columns, rows);
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <complex>
+#include <memory>
+#include <vector>
+#include "FftPlan.h"
+#include "SampleBlock.h"
+
+// Computes very large FFTs, of a million points or more, across several threads with the six-step algorithm.
+// The samples are treated as a matrix whose rows are transformed independently by small FftPlans, so each thread's
+//  working set stays in its L2 cache, with cache-blocked transposes between the row passes.
+class LargeFourierTransform
+{
+    // Transposes are done in square tiles of this many samples per side (8 KiB of input per tile).
+    static const unsigned int tileSize = 32;
+
+    unsigned int size;
+    unsigned int threadCount;
+
+    // size = rows * columns, with rows the largest divisor no greater than the square root of the size.
+    unsigned int rows;
+    unsigned int columns;
+    std::shared_ptr<const FftPlan> rowPlan;
+    std::shared_ptr<const FftPlan> columnPlan;
+
+    // e^(-2 PI i m / size) = coarseTwiddles[m / columns] * fineTwiddles[m % columns], so the full table is never stored.
+    std::vector<std::complex<float>> coarseTwiddles;
+    std::vector<std::complex<float>> fineTwiddles;
+
+    SampleBlock<std::complex<float>> firstWorkspace;
+    SampleBlock<std::complex<float>> secondWorkspace;
+
+    // Splits [0, count) into one range per thread, running the first on the calling thread.
+    template<typename Function>
+    void ParallelFor(unsigned int count, Function function) const;
+
+    void Transpose(const std::complex<float>* input, std::complex<float>* output, unsigned int inputRows, unsigned int inputColumns) const;
+    void TransformRows(const std::complex<float>* input, std::complex<float>* output, unsigned int rowCount, const FftPlan& plan, bool applyTwiddles) const;
+
+public:
+    // A thread count of 0 uses every hardware thread.
+    LargeFourierTransform(unsigned int size, unsigned int threadCount);
+
+    unsigned int GetSize() const;
+    unsigned int GetThreadCount() const;
+    void SetThreadCount(unsigned int threadCount);
+
+    // Computes the forward FFT of exactly GetSize() samples, with DC first and negative frequencies in the upper half.
+    bool Transform(SampleView<const std::complex<float>> samples, SampleBlock<std::complex<float>>& spectrum);
+};
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include "PlotDecimator.h"
+
+PlotDecimator::PlotDecimator()
+    : claimedPixels(), columns(0), rows(0)
+{
+}
+
+void PlotDecimator::MinMaxEnvelope(const std::vector<float>& values, unsigned int columns, std::vector<float>& envelope)
+{
+    envelope.clear();
+    if (columns == 0 || values.size() <= (std::size_t)columns * 2)
+    {
+        envelope.insert(envelope.end(), values.begin(), values.end());
+        return;
+    }
+
+    for (unsigned int column = 0; column < columns; column++)
+    {
+        std::size_t start = (std::size_t)column * values.size() / columns;
+        std::size_t end = (std::size_t)(column + 1) * values.size() / columns;
+
+        std::size_t minIndex = start;
+        std::size_t maxIndex = start;
+        for (std::size_t i = start + 1; i < end; i++)
+        {
+            if (values[i] < values[minIndex])
+            {
+                minIndex = i;
+            }
+            else if (values[i] > values[maxIndex])
+            {
+                maxIndex = i;
+            }
+        }
+
+        // Emitting in sample order keeps the strip from zig-zagging back across a peak.
+        envelope.push_back(values[std::min(minIndex, maxIndex)]);
+        envelope.push_back(values[std::max(minIndex, maxIndex)]);
+    }
+}
+
+void PlotDecimator::ResetPixels(unsigned int columns, unsigned int rows)
+{
+    this->columns = columns;
+    this->rows = rows;
+    claimedPixels.assign((std::size_t)columns * rows, false);
+}
+
+bool PlotDecimator::ClaimPixel(float x, float y)
+{
+    if (columns == 0 || rows == 0)
+    {
+        return true;
+    }
+
+    unsigned int column = (unsigned int)std::min(std::max(x, 0.0f) * columns, (float)(columns - 1));
+    unsigned int row = (unsigned int)std::min(std::max(y, 0.0f) * rows, (float)(rows - 1));
+
+    std::size_t pixel = (std::size_t)row * columns + column;
+    if (claimedPixels[pixel])
+    {
+        return false;
+    }
+
+    claimedPixels[pixel] = true;
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+
+// Reduces plotted data to what a pane can show, so vertex counts follow the pane's pixel size rather than the data size.
+class PlotDecimator
+{
+    std::vector<bool> claimedPixels;
+    unsigned int columns;
+    unsigned int rows;
+
+public:
+    PlotDecimator();
+
+    // Reduces evenly spaced values to the minimum and maximum of each pixel column, in the order they occur, so a
+    //  line strip through them covers the same vertical extent as the full data. Values already at two or fewer per
+    //  column are copied unchanged. The envelope is also evenly spaced, across the same width.
+    static void MinMaxEnvelope(const std::vector<float>& values, unsigned int columns, std::vector<float>& envelope);
+
+    // Clears the pixel grid used to thin scattered points, resizing it as needed.
+    void ResetPixels(unsigned int columns, unsigned int rows);
+
+    // Claims the pixel under a point, given as fractions [0, 1] of the grid's width and height.
+    // Returns false if the pixel was already claimed, in which case the point adds nothing to the plot.
+    bool ClaimPixel(float x, float y);
+};
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstring>
+#include "PowerSpectrum.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define POWER_SPECTRUM_SSE2
+#include <emmintrin.h>
+#endif
+
+PowerSpectrum::PowerSpectrum(unsigned int fftSize, SpectrumWindow windowType, float overlap)
+    : transform(fftSize, windowType, overlap), averaging(SpectrumAveraging::Exponential), exponentialFactor(0.05f),
+      averagePower(fftSize, 0.0f), segmentCount(0)
+{
+}
+
+void PowerSpectrum::SetAveraging(SpectrumAveraging averaging, float exponentialFactor)
+{
+    this->averaging = averaging;
+    this->exponentialFactor = exponentialFactor;
+    segmentCount = 0;
+}
+
+void PowerSpectrum::AddSamples(SampleView<const std::complex<float>> samples)
+{
+    unsigned int frames = transform.Transform(samples);
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        AddSegment(transform.GetSpectrum(i));
+    }
+}
+
+void PowerSpectrum::AddSegment(SampleView<const std::complex<float>> spectrum)
+{
+    ++segmentCount;
+
+    unsigned int fftSize = transform.GetFftSize();
+    float* power = averagePower.data();
+    switch (averaging)
+    {
+    case SpectrumAveraging::Linear:
+    {
+        float weight = 1.0f / (float)segmentCount;
+        for (unsigned int i = 0; i < fftSize; i++)
+        {
+            power[i] += weight * (std::norm(spectrum[i]) - power[i]);
+        }
+
+        break;
+    }
+    case SpectrumAveraging::Exponential:
+    {
+        // The first segment seeds the average, so it doesn't have to climb up from zero.
+        float weight = segmentCount == 1 ? 1.0f : exponentialFactor;
+        for (unsigned int i = 0; i < fftSize; i++)
+        {
+            power[i] += weight * (std::norm(spectrum[i]) - power[i]);
+        }
+
+        break;
+    }
+    case SpectrumAveraging::PeakHold:
+    {
+        for (unsigned int i = 0; i < fftSize; i++)
+        {
+            float segmentPower = std::norm(spectrum[i]);
+            power[i] = segmentCount == 1 ? segmentPower : std::max(power[i], segmentPower);
+        }
+
+        break;
+    }
+    }
+}
+
+void PowerSpectrum::Reset()
+{
+    transform.Reset();
+    segmentCount = 0;
+}
+
+unsigned int PowerSpectrum::GetFftSize() const
+{
+    return transform.GetFftSize();
+}
+
+unsigned int PowerSpectrum::GetSegmentCount() const
+{
+    return segmentCount;
+}
+
+void PowerSpectrum::GetPower(std::vector<float>& power) const
+{
+    unsigned int fftSize = transform.GetFftSize();
+    power.resize(fftSize);
+    if (segmentCount == 0)
+    {
+        std::fill(power.begin(), power.end(), 0.0f);
+        return;
+    }
+
+    // FFT bins are stored with DC first and negative frequencies in the upper half.
+    for (unsigned int i = 0; i < fftSize; i++)
+    {
+        power[i] = averagePower[(i + fftSize / 2) % fftSize];
+    }
+}
+
+void PowerSpectrum::GetPowerDb(std::vector<float>& powerDb) const
+{
+    GetPower(powerDb);
+    ToDecibels(powerDb.data(), powerDb.data(), powerDb.size());
+}
+
+void PowerSpectrum::ToDecibels(const float* power, float* decibels, std::size_t count)
+{
+    // log2(x) = exponent + log2(mantissa). The mantissa, in [1, 2), is fit with a quartic.
+    // Then 10 * log10(x) = log2(x) * 10 * log10(2).
+    const float c0 = -2.51278899f;
+    const float c1 = 4.06993145f;
+    const float c2 = -2.12053606f;
+    const float c3 = 0.64509102f;
+    const float c4 = -0.08160913f;
+    const float decibelsPerOctave = 3.0103f;
+    const float minimumPower = 1e-20f;
+
+    std::size_t i = 0;
+#ifdef POWER_SPECTRUM_SSE2
+    const __m128 minimum = _mm_set1_ps(minimumPower);
+    const __m128i exponentMask = _mm_set1_epi32(0x7F800000);
+    const __m128i mantissaMask = _mm_set1_epi32(0x007FFFFF);
+    const __m128i one = _mm_set1_epi32(0x3F800000);
+    const __m128i exponentBias = _mm_set1_epi32(127);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i bits = _mm_castps_si128(_mm_max_ps(_mm_loadu_ps(power + i), minimum));
+        __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_and_si128(bits, exponentMask), 23), exponentBias));
+        __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), one));
+
+        __m128 polynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c4), mantissa), _mm_set1_ps(c3));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, mantissa), _mm_set1_ps(c2));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, mantissa), _mm_set1_ps(c1));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, mantissa), _mm_set1_ps(c0));
+
+        _mm_storeu_ps(decibels + i, _mm_mul_ps(_mm_add_ps(exponent, polynomial), _mm_set1_ps(decibelsPerOctave)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        unsigned int bits;
+        float value = std::max(power[i], minimumPower);
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        float exponent = (float)((int)((bits & 0x7F800000) >> 23) - 127);
+        unsigned int mantissaBits = (bits & 0x007FFFFF) | 0x3F800000;
+        float mantissa;
+        std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+
+        float polynomial = (((c4 * mantissa + c3) * mantissa + c2) * mantissa + c1) * mantissa + c0;
+        decibels[i] = (exponent + polynomial) * decibelsPerOctave;
+    }
+}
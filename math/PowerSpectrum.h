@@ -0,0 +1,61 @@
+#pragma once
+#include <complex>
+#include <vector>
+#include "SampleBlock.h"
+#include "ShortTimeFourierTransform.h"
+
+// How successive segment spectra are combined.
+enum class SpectrumAveraging
+{
+    // Mean of every segment since the last reset.
+    Linear,
+
+    // Exponentially-weighted mean, favoring recent segments.
+    Exponential,
+
+    // Maximum of every segment since the last reset.
+    PeakHold
+};
+
+// Estimates the power spectral density of a sample stream with Welch's method:
+//  overlapping windowed segments are transformed and their power averaged incrementally.
+// Has no dependencies on the SDR or graphics, so can be used headless.
+class PowerSpectrum
+{
+    // Segments the stream, and windows it so a full-scale tone centered in a bin reads 0 dB.
+    ShortTimeFourierTransform transform;
+    SpectrumAveraging averaging;
+    float exponentialFactor;
+
+    std::vector<float> averagePower;
+    unsigned int segmentCount;
+
+    void AddSegment(SampleView<const std::complex<float>> spectrum);
+
+public:
+    // Overlap is the fraction of each segment shared with the next, in [0, 1). 0.5 is typical for Hamming and Blackman windows.
+    PowerSpectrum(unsigned int fftSize, SpectrumWindow windowType, float overlap);
+
+    // Changes how segments are averaged, resetting the current average.
+    // The exponential factor is the weight given to each new segment.
+    void SetAveraging(SpectrumAveraging averaging, float exponentialFactor);
+
+    // Adds samples to the estimate, continuing the segment left incomplete by the previous call.
+    void AddSamples(SampleView<const std::complex<float>> samples);
+
+    // Discards the current estimate and any pending samples.
+    void Reset();
+
+    unsigned int GetFftSize() const;
+    unsigned int GetSegmentCount() const;
+
+    // Retrieves the averaged linear power, relative to full scale, with the lowest frequency first and DC in the center.
+    void GetPower(std::vector<float>& power) const;
+
+    // Retrieves the averaged power in dBFS, with the lowest frequency first and DC in the center.
+    void GetPowerDb(std::vector<float>& powerDb) const;
+
+    // Converts power values to decibels with a polynomial log approximation, accurate to better than 0.001 dB.
+    // Values at or below zero are clamped to -200 dB.
+    static void ToDecibels(const float* power, float* decibels, std::size_t count);
+};
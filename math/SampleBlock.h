@@ -0,0 +1,212 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include "AlignedAllocator.h"
+
+// Raw interleaved sample as read from the RTL-SDR. Subtract 127.5 to get the actual value.
+struct IqByte
+{
+    unsigned char i;
+    unsigned char q;
+};
+
+// Complex Q15 (1.15 fixed-point) sample. std::complex is only defined for floating-point types.
+struct ComplexInt16
+{
+    short i;
+    short q;
+};
+
+// Defines how each sample type converts to a normalized complex float.
+// Templated kernels work in float; the Q15 fast paths (such as DecimateFixedPoint) are separate functions.
+template<typename T>
+struct SampleTraits;
+
+// Constant samples convert the same way as mutable ones.
+template<typename T>
+struct SampleTraits<const T> : public SampleTraits<T>
+{
+};
+
+template<>
+struct SampleTraits<std::complex<float>>
+{
+    static std::complex<float> ToComplexFloat(const std::complex<float>& sample)
+    {
+        return sample;
+    }
+};
+
+template<>
+struct SampleTraits<ComplexInt16>
+{
+    static std::complex<float> ToComplexFloat(const ComplexInt16& sample)
+    {
+        return std::complex<float>((float)sample.i / 32768.0f, (float)sample.q / 32768.0f);
+    }
+};
+
+template<>
+struct SampleTraits<IqByte>
+{
+    static std::complex<float> ToComplexFloat(const IqByte& sample)
+    {
+        return std::complex<float>(((float)sample.i - 127.5f) / 127.5f, ((float)sample.q - 127.5f) / 127.5f);
+    }
+};
+
+// Non-owning view of a contiguous range of samples.
+template<typename T>
+class SampleView
+{
+    T* samples;
+    std::size_t length;
+
+public:
+    SampleView()
+        : samples(nullptr), length(0)
+    {
+    }
+
+    SampleView(T* samples, std::size_t length)
+        : samples(samples), length(length)
+    {
+    }
+
+    // Permits viewing mutable samples as constant ones.
+    template<typename U>
+    SampleView(const SampleView<U>& other)
+        : samples(other.data()), length(other.size())
+    {
+    }
+
+    T* data() const
+    {
+        return samples;
+    }
+
+    std::size_t size() const
+    {
+        return length;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    T* begin() const
+    {
+        return samples;
+    }
+
+    T* end() const
+    {
+        return samples + length;
+    }
+
+    T& operator[](std::size_t index) const
+    {
+        return samples[index];
+    }
+
+    // Returns a view of part of this view. The range must lie within this view.
+    SampleView<T> Subview(std::size_t offset, std::size_t count) const
+    {
+        return SampleView<T>(samples + offset, count);
+    }
+};
+
+// Owning, SIMD-aligned block of samples.
+template<typename T>
+class SampleBlock
+{
+    std::vector<T, AlignedAllocator<T>> samples;
+
+public:
+    SampleBlock()
+        : samples()
+    {
+    }
+
+    explicit SampleBlock(std::size_t length)
+        : samples(length)
+    {
+    }
+
+    SampleView<T> View()
+    {
+        return SampleView<T>(samples.data(), samples.size());
+    }
+
+    SampleView<const T> View() const
+    {
+        return SampleView<const T>(samples.data(), samples.size());
+    }
+
+    SampleView<T> Subview(std::size_t offset, std::size_t count)
+    {
+        return SampleView<T>(samples.data() + offset, count);
+    }
+
+    SampleView<const T> Subview(std::size_t offset, std::size_t count) const
+    {
+        return SampleView<const T>(samples.data() + offset, count);
+    }
+
+    void Resize(std::size_t length)
+    {
+        samples.resize(length);
+    }
+
+    void Reserve(std::size_t length)
+    {
+        samples.reserve(length);
+    }
+
+    void Clear()
+    {
+        samples.clear();
+    }
+
+    void PushBack(const T& sample)
+    {
+        samples.push_back(sample);
+    }
+
+    void Assign(SampleView<const T> view)
+    {
+        samples.assign(view.begin(), view.end());
+    }
+
+    T* data()
+    {
+        return samples.data();
+    }
+
+    const T* data() const
+    {
+        return samples.data();
+    }
+
+    std::size_t size() const
+    {
+        return samples.size();
+    }
+
+    bool empty() const
+    {
+        return samples.empty();
+    }
+
+    T& operator[](std::size_t index)
+    {
+        return samples[index];
+    }
+
+    const T& operator[](std::size_t index) const
+    {
+        return samples[index];
+    }
+};
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include "logging\Logger.h"
+#include "Constants.h"
+#include "CustomFilter.h"
+#include "FourierTransform.h"
+#include "ShortTimeFourierTransform.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define STFT_SSE2
+#include <emmintrin.h>
+#endif
+
+ShortTimeFourierTransform::ShortTimeFourierTransform(unsigned int fftSize, SpectrumWindow windowType, float overlap)
+    : fftSize(fftSize), window(fftSize), bitReversal(fftSize), twiddleReals(fftSize / 2), twiddleImags(fftSize / 2),
+      pendingSamples(), batchReals(fftSize * batchFrames), batchImags(fftSize * batchFrames), spectra(), frameCount(0)
+{
+    if (fftSize < 2 || (fftSize & (fftSize - 1)) != 0)
+    {
+        Logger::LogError("The STFT size must be a power of 2: ", fftSize);
+    }
+
+    hopSize = std::max(1u, (unsigned int)((float)fftSize * (1.0f - std::min(std::max(overlap, 0.0f), 0.99f))));
+
+    float windowSum = 0.0f;
+    for (unsigned int i = 0; i < fftSize; i++)
+    {
+        switch (windowType)
+        {
+        case SpectrumWindow::Hamming:
+            window[i] = CustomFilter::ComputeHammingWindowPt(i, fftSize);
+            break;
+        case SpectrumWindow::Blackman:
+            window[i] = CustomFilter::ComputeBlackmanWindowPt(i, fftSize);
+            break;
+        default:
+            window[i] = 1.0f;
+            break;
+        }
+
+        windowSum += window[i];
+    }
+
+    for (unsigned int i = 0; i < fftSize; i++)
+    {
+        window[i] /= windowSum;
+    }
+
+    unsigned int bits = 0;
+    while ((1u << bits) < fftSize)
+    {
+        ++bits;
+    }
+
+    for (unsigned int i = 0; i < fftSize; i++)
+    {
+        unsigned int reversed = 0;
+        for (unsigned int bit = 0; bit < bits; bit++)
+        {
+            reversed |= ((i >> bit) & 1) << (bits - bit - 1);
+        }
+
+        bitReversal[i] = reversed;
+    }
+
+    for (unsigned int i = 0; i < fftSize / 2; i++)
+    {
+        float angle = -2.0f * Constants::PI * (float)i / (float)fftSize;
+        twiddleReals[i] = std::cos(angle);
+        twiddleImags[i] = std::sin(angle);
+    }
+}
+
+void ShortTimeFourierTransform::LoadFrame(SampleView<const std::complex<float>> samples, std::size_t position, unsigned int lane)
+{
+    std::size_t pendingLength = pendingSamples.size();
+    std::size_t fromPending = position < pendingLength ? std::min<std::size_t>(fftSize, pendingLength - position) : 0;
+    const std::complex<float>* oldSamples = pendingSamples.data() + std::min(position, pendingLength);
+    const std::complex<float>* newSamples = samples.data() + (position + fromPending - pendingLength);
+
+    for (std::size_t i = 0; i < fromPending; i++)
+    {
+        std::size_t index = bitReversal[i] * batchFrames + lane;
+        batchReals[index] = oldSamples[i].real() * window[i];
+        batchImags[index] = oldSamples[i].imag() * window[i];
+    }
+
+    for (std::size_t i = fromPending; i < fftSize; i++)
+    {
+        std::size_t index = bitReversal[i] * batchFrames + lane;
+        batchReals[index] = newSamples[i - fromPending].real() * window[i];
+        batchImags[index] = newSamples[i - fromPending].imag() * window[i];
+    }
+}
+
+void ShortTimeFourierTransform::TransformBatch()
+{
+    float* reals = batchReals.data();
+    float* imags = batchImags.data();
+    for (unsigned int halfSize = 1; halfSize < fftSize; halfSize *= 2)
+    {
+        unsigned int twiddleStep = fftSize / (halfSize * 2);
+        for (unsigned int j = 0; j < halfSize; j++)
+        {
+            float ur = twiddleReals[j * twiddleStep];
+            float ui = twiddleImags[j * twiddleStep];
+
+#ifdef STFT_SSE2
+            // The same twiddle applies to every frame in the batch.
+            __m128 wr = _mm_set1_ps(ur);
+            __m128 wi = _mm_set1_ps(ui);
+            for (unsigned int i = j; i < fftSize; i += halfSize * 2)
+            {
+                float* real = reals + i * batchFrames;
+                float* imag = imags + i * batchFrames;
+                float* realPair = reals + (i + halfSize) * batchFrames;
+                float* imagPair = imags + (i + halfSize) * batchFrames;
+
+                __m128 pairReal = _mm_load_ps(realPair);
+                __m128 pairImag = _mm_load_ps(imagPair);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(pairReal, wr), _mm_mul_ps(pairImag, wi));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(pairReal, wi), _mm_mul_ps(pairImag, wr));
+
+                __m128 valueReal = _mm_load_ps(real);
+                __m128 valueImag = _mm_load_ps(imag);
+                _mm_store_ps(realPair, _mm_sub_ps(valueReal, tr));
+                _mm_store_ps(imagPair, _mm_sub_ps(valueImag, ti));
+                _mm_store_ps(real, _mm_add_ps(valueReal, tr));
+                _mm_store_ps(imag, _mm_add_ps(valueImag, ti));
+            }
+#else
+            for (unsigned int i = j; i < fftSize; i += halfSize * 2)
+            {
+                float* real = reals + i * batchFrames;
+                float* imag = imags + i * batchFrames;
+                float* realPair = reals + (i + halfSize) * batchFrames;
+                float* imagPair = imags + (i + halfSize) * batchFrames;
+                for (unsigned int lane = 0; lane < batchFrames; lane++)
+                {
+                    float tr = realPair[lane] * ur - imagPair[lane] * ui;
+                    float ti = realPair[lane] * ui + imagPair[lane] * ur;
+                    realPair[lane] = real[lane] - tr;
+                    imagPair[lane] = imag[lane] - ti;
+                    real[lane] += tr;
+                    imag[lane] += ti;
+                }
+            }
+#endif
+        }
+    }
+}
+
+void ShortTimeFourierTransform::StoreBatch(unsigned int firstFrame, unsigned int frames)
+{
+    for (unsigned int lane = 0; lane < frames; lane++)
+    {
+        std::complex<float>* spectrum = spectra.data() + (std::size_t)(firstFrame + lane) * fftSize;
+        for (unsigned int i = 0; i < fftSize; i++)
+        {
+            spectrum[i] = std::complex<float>(batchReals[i * batchFrames + lane], batchImags[i * batchFrames + lane]);
+        }
+    }
+}
+
+unsigned int ShortTimeFourierTransform::Transform(SampleView<const std::complex<float>> samples)
+{
+    std::size_t pendingLength = pendingSamples.size();
+    std::size_t totalLength = pendingLength + samples.size();
+    frameCount = totalLength >= fftSize ? (unsigned int)((totalLength - fftSize) / hopSize + 1) : 0;
+    spectra.Resize((std::size_t)frameCount * fftSize);
+
+    for (unsigned int frame = 0; frame < frameCount; frame += batchFrames)
+    {
+        unsigned int frames = std::min(batchFrames, frameCount - frame);
+        for (unsigned int lane = 0; lane < frames; lane++)
+        {
+            LoadFrame(samples, (std::size_t)(frame + lane) * hopSize, lane);
+        }
+
+        TransformBatch();
+        StoreBatch(frame, frames);
+    }
+
+    // Keep everything from the start of the next frame onwards.
+    std::size_t position = (std::size_t)frameCount * hopSize;
+    if (position < pendingLength)
+    {
+        std::copy(pendingSamples.data() + position, pendingSamples.data() + pendingLength, pendingSamples.data());
+        pendingSamples.Resize(totalLength - position);
+        std::copy(samples.begin(), samples.end(), pendingSamples.data() + (pendingLength - position));
+    }
+    else
+    {
+        pendingSamples.Assign(samples.Subview(position - pendingLength, totalLength - position));
+    }
+
+    return frameCount;
+}
+
+void ShortTimeFourierTransform::Reset()
+{
+    pendingSamples.Clear();
+    frameCount = 0;
+}
+
+unsigned int ShortTimeFourierTransform::GetFftSize() const
+{
+    return fftSize;
+}
+
+unsigned int ShortTimeFourierTransform::GetHopSize() const
+{
+    return hopSize;
+}
+
+unsigned int ShortTimeFourierTransform::GetFrameCount() const
+{
+    return frameCount;
+}
+
+SampleView<const std::complex<float>> ShortTimeFourierTransform::GetSpectrum(unsigned int frame) const
+{
+    return spectra.Subview((std::size_t)frame * fftSize, fftSize);
+}
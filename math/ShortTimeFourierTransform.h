@@ -0,0 +1,63 @@
+#pragma once
+#include <complex>
+#include <vector>
+#include "SampleBlock.h"
+
+// Window applied to each frame before its FFT.
+enum class SpectrumWindow
+{
+    Rectangular,
+    Hamming,
+    Blackman
+};
+
+// Slices a sample stream into overlapping windowed frames, and transforms them in batches.
+// Each SIMD lane holds a different frame, so every butterfly is fully vectorized regardless of the FFT size.
+// Samples that start the next frame are carried over, so frames continue across calls.
+class ShortTimeFourierTransform
+{
+    static const unsigned int batchFrames = 4;
+
+    unsigned int fftSize;
+    unsigned int hopSize;
+
+    // The window is pre-scaled by its coherent gain, so a full-scale tone centered in a bin has a magnitude of 1.
+    std::vector<float> window;
+    std::vector<unsigned int> bitReversal;
+    std::vector<float> twiddleReals;
+    std::vector<float> twiddleImags;
+
+    // Samples left over from the last call, which start the next frame.
+    SampleBlock<std::complex<float>> pendingSamples;
+
+    // The batch being transformed, in bit-reversed order, with the frames of each bin adjacent: [bin][frame].
+    SampleBlock<float> batchReals;
+    SampleBlock<float> batchImags;
+
+    // Transformed frames from the last call, one after the other.
+    SampleBlock<std::complex<float>> spectra;
+    unsigned int frameCount;
+
+    // Windows the frame starting at the position (counting through the pending samples, then the new ones) into a batch lane.
+    void LoadFrame(SampleView<const std::complex<float>> samples, std::size_t position, unsigned int lane);
+    void TransformBatch();
+    void StoreBatch(unsigned int firstFrame, unsigned int frames);
+
+public:
+    // The FFT size must be a power of 2. Overlap is the fraction of each frame shared with the next, in [0, 1).
+    ShortTimeFourierTransform(unsigned int fftSize, SpectrumWindow windowType, float overlap);
+
+    // Transforms every frame that can be completed with these samples, replacing the spectra of the last call.
+    // Returns the number of frames transformed.
+    unsigned int Transform(SampleView<const std::complex<float>> samples);
+
+    // Discards any pending samples, so the next frame starts with the next samples provided.
+    void Reset();
+
+    unsigned int GetFftSize() const;
+    unsigned int GetHopSize() const;
+    unsigned int GetFrameCount() const;
+
+    // Returns the spectrum of a frame from the last call, with DC first and negative frequencies in the upper half.
+    SampleView<const std::complex<float>> GetSpectrum(unsigned int frame) const;
+};
@@ -29,6 +29,8 @@ void WindowedSincFilter::CreateFilter(int kernelLength)
     {
         kernel[i] /= sum;
     }
+
+    fixedPointKernel = FixedPoint::CreateKernel(kernel);
 }
 
 void WindowedSincFilter::CreateFilter(float cutoffFrequency, int kernelLength)
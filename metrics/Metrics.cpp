@@ -0,0 +1,83 @@
+#include "Metrics.h"
+
+LatencyHistogram::LatencyHistogram()
+    : count(0), sum(0), max(0)
+{
+    for (unsigned int i = 0; i < bucketCount; i++)
+    {
+        buckets[i] = 0;
+    }
+}
+
+unsigned int LatencyHistogram::GetBucketIndex(unsigned long long microseconds)
+{
+    if (microseconds < exactLimit)
+    {
+        return (unsigned int)microseconds;
+    }
+
+    unsigned int exponent = 0;
+    for (unsigned long long remaining = microseconds >> 1; remaining != 0; remaining >>= 1)
+    {
+        ++exponent;
+    }
+
+    if (exponent > maxExponent)
+    {
+        return bucketCount - 1;
+    }
+
+    // The top subBucketBits + 1 bits select the bucket within this power of two.
+    unsigned int shift = exponent - subBucketBits;
+    unsigned int subBucket = (unsigned int)(microseconds >> shift) - subBucketCount;
+    return (shift + 1) * subBucketCount + subBucket;
+}
+
+unsigned long long LatencyHistogram::GetBucketUpperBound(unsigned int index)
+{
+    if (index < exactLimit)
+    {
+        return index;
+    }
+
+    unsigned int shift = index / subBucketCount - 1;
+    unsigned long long subBucket = subBucketCount + index % subBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+LatencySnapshot LatencyHistogram::GetSnapshot() const
+{
+    unsigned long long bucketCounts[bucketCount];
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < bucketCount; i++)
+    {
+        bucketCounts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += bucketCounts[i];
+    }
+
+    LatencySnapshot snapshot;
+    snapshot.count = total;
+    snapshot.max = max.load(std::memory_order_relaxed);
+    snapshot.mean = total == 0 ? 0.0 : (double)sum.load(std::memory_order_relaxed) / (double)count.load(std::memory_order_relaxed);
+
+    const double percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    unsigned long long* values[] = { &snapshot.p50, &snapshot.p90, &snapshot.p99, &snapshot.p999 };
+    for (unsigned int p = 0; p < 4; p++)
+    {
+        // The value at or below which the percentile of recordings fall.
+        unsigned long long rank = (unsigned long long)(percentiles[p] * (double)total + 0.5);
+        unsigned long long seen = 0;
+        *values[p] = 0;
+        for (unsigned int i = 0; i < bucketCount && total != 0; i++)
+        {
+            seen += bucketCounts[i];
+            if (seen >= std::max(rank, 1ULL))
+            {
+                *values[p] = std::min(GetBucketUpperBound(i), snapshot.max);
+                break;
+            }
+        }
+    }
+
+    return snapshot;
+}
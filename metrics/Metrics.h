@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+// Metrics updated on hot paths. Updates are single relaxed atomic operations, so are safe from any thread
+//  and cost about as much as an uncontended increment. Owners register them with the MetricsRegistry to expose them.
+
+// Monotonically increasing count of events.
+class Counter
+{
+    std::atomic<unsigned long long> value;
+
+public:
+    Counter()
+        : value(0)
+    {
+    }
+
+    void Increment(unsigned long long count = 1)
+    {
+        value.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    unsigned long long Get() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+// Most recent value of a level, such as a rate or a queue depth.
+class Gauge
+{
+    std::atomic<double> value;
+
+public:
+    Gauge()
+        : value(0.0)
+    {
+    }
+
+    void Set(double newValue)
+    {
+        value.store(newValue, std::memory_order_relaxed);
+    }
+
+    double Get() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+// Summary of a LatencyHistogram at a point in time. Durations are in microseconds.
+struct LatencySnapshot
+{
+    unsigned long long count;
+    double mean;
+    unsigned long long max;
+    unsigned long long p50;
+    unsigned long long p90;
+    unsigned long long p99;
+    unsigned long long p999;
+};
+
+// Distribution of durations, in microseconds, with buckets laid out as in an HDR histogram: exact below 32 us,
+//  then 16 linear buckets per power of two, so any percentile is within 6.25% of the true value up to ~19 hours.
+class LatencyHistogram
+{
+    static const unsigned int subBucketBits = 4;
+    static const unsigned int subBucketCount = 1 << subBucketBits;
+    static const unsigned int exactLimit = subBucketCount * 2;
+    static const unsigned int maxExponent = 35;
+    static const unsigned int bucketCount = (maxExponent - subBucketBits + 2) * subBucketCount;
+
+    std::atomic<unsigned int> buckets[bucketCount];
+    std::atomic<unsigned long long> count;
+    std::atomic<unsigned long long> sum;
+    std::atomic<unsigned long long> max;
+
+    static unsigned int GetBucketIndex(unsigned long long microseconds);
+
+    // Largest value that falls into the bucket.
+    static unsigned long long GetBucketUpperBound(unsigned int index);
+
+public:
+    LatencyHistogram();
+
+    void Record(unsigned long long microseconds)
+    {
+        buckets[GetBucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+        unsigned long long currentMax = max.load(std::memory_order_relaxed);
+        while (microseconds > currentMax && !max.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    template<typename Rep, typename Period>
+    void Record(std::chrono::duration<Rep, Period> duration)
+    {
+        long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        Record((unsigned long long)std::max(microseconds, 0LL));
+    }
+
+    // Percentiles are the upper bound of the bucket they fall in, so never understate the latency.
+    // Concurrent recording may be partially included.
+    LatencySnapshot GetSnapshot() const;
+};
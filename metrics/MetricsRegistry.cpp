@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include "logging\Logger.h"
+#include "MetricsRegistry.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+std::mutex MetricsRegistry::registryLock;
+std::map<std::string, const Counter*> MetricsRegistry::counters;
+std::map<std::string, const Gauge*> MetricsRegistry::gauges;
+std::map<std::string, const LatencyHistogram*> MetricsRegistry::histograms;
+
+std::atomic<bool> MetricsRegistry::dumping(false);
+std::future<void> MetricsRegistry::dumpThread;
+
+void MetricsRegistry::Register(const std::string& name, const Counter* counter)
+{
+    std::lock_guard<std::mutex> lock(registryLock);
+    counters[name] = counter;
+}
+
+void MetricsRegistry::Register(const std::string& name, const Gauge* gauge)
+{
+    std::lock_guard<std::mutex> lock(registryLock);
+    gauges[name] = gauge;
+}
+
+void MetricsRegistry::Register(const std::string& name, const LatencyHistogram* histogram)
+{
+    std::lock_guard<std::mutex> lock(registryLock);
+    histograms[name] = histogram;
+}
+
+void MetricsRegistry::Unregister(const std::string& name, const void* metric)
+{
+    std::lock_guard<std::mutex> lock(registryLock);
+
+    auto counter = counters.find(name);
+    if (counter != counters.end() && counter->second == metric)
+    {
+        counters.erase(counter);
+    }
+
+    auto gauge = gauges.find(name);
+    if (gauge != gauges.end() && gauge->second == metric)
+    {
+        gauges.erase(gauge);
+    }
+
+    auto histogram = histograms.find(name);
+    if (histogram != histograms.end() && histogram->second == metric)
+    {
+        histograms.erase(histogram);
+    }
+}
+
+void MetricsRegistry::WriteSnapshot(std::ostream& output)
+{
+    std::lock_guard<std::mutex> lock(registryLock);
+
+    long long timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    output << "{\n  \"timestampMs\": " << timestamp << ",\n  \"counters\": {";
+
+    const char* separator = "\n";
+    for (const auto& counter : counters)
+    {
+        output << separator << "    \"" << counter.first << "\": " << counter.second->Get();
+        separator = ",\n";
+    }
+
+    output << "\n  },\n  \"gauges\": {";
+    separator = "\n";
+    for (const auto& gauge : gauges)
+    {
+        output << separator << "    \"" << gauge.first << "\": " << gauge.second->Get();
+        separator = ",\n";
+    }
+
+    output << "\n  },\n  \"histograms\": {";
+    separator = "\n";
+    for (const auto& histogram : histograms)
+    {
+        LatencySnapshot snapshot = histogram.second->GetSnapshot();
+        output << separator << "    \"" << histogram.first << "\": { \"count\": " << snapshot.count << ", \"meanUs\": " << snapshot.mean
+               << ", \"p50Us\": " << snapshot.p50 << ", \"p90Us\": " << snapshot.p90 << ", \"p99Us\": " << snapshot.p99
+               << ", \"p999Us\": " << snapshot.p999 << ", \"maxUs\": " << snapshot.max << " }";
+        separator = ",\n";
+    }
+
+    output << "\n  }\n}\n";
+}
+
+bool MetricsRegistry::WriteSnapshot(const std::string& path)
+{
+    // Written aside and then swapped in, so readers never see a partial snapshot, or no file at all.
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream output(temporaryPath, std::ios::trunc);
+        if (!output)
+        {
+            return false;
+        }
+
+        WriteSnapshot(output);
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    // POSIX rename replaces the destination atomically.
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+}
+
+void MetricsRegistry::DumpPeriodically(std::string path, float intervalSeconds)
+{
+    bool warned = false;
+    while (dumping)
+    {
+        // Sleep in short steps, so stopping doesn't wait out a whole interval.
+        for (float slept = 0.0f; dumping && slept < intervalSeconds; slept += 0.1f)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        if (!WriteSnapshot(path) && !warned)
+        {
+            Logger::LogWarn("Unable to write the metrics snapshot to '", path, "'.");
+            warned = true;
+        }
+    }
+}
+
+void MetricsRegistry::StartPeriodicDump(const std::string& path, float intervalSeconds)
+{
+    StopPeriodicDump();
+
+    Logger::Log("Writing metrics to '", path, "' every ", intervalSeconds, " s.");
+    dumping = true;
+    dumpThread = std::async(std::launch::async, &MetricsRegistry::DumpPeriodically, path, intervalSeconds);
+}
+
+void MetricsRegistry::StopPeriodicDump()
+{
+    dumping = false;
+    if (dumpThread.valid())
+    {
+        dumpThread.wait();
+    }
+}
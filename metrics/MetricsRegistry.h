@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include "Metrics.h"
+
+// Names the metrics owned throughout the program, so they can be snapshotted together.
+// Metrics are registered and unregistered by their owners, and must be unregistered before they're destroyed.
+// Registration and snapshots take a lock; updating a metric never does.
+class MetricsRegistry
+{
+    static std::mutex registryLock;
+    static std::map<std::string, const Counter*> counters;
+    static std::map<std::string, const Gauge*> gauges;
+    static std::map<std::string, const LatencyHistogram*> histograms;
+
+    static std::atomic<bool> dumping;
+    static std::future<void> dumpThread;
+
+    static void DumpPeriodically(std::string path, float intervalSeconds);
+
+public:
+    // Registering a name again replaces the metric it refers to.
+    static void Register(const std::string& name, const Counter* counter);
+    static void Register(const std::string& name, const Gauge* gauge);
+    static void Register(const std::string& name, const LatencyHistogram* histogram);
+
+    // Removes a metric, if it's still registered under the name, so a replacement registered since is kept.
+    static void Unregister(const std::string& name, const void* metric);
+
+    // Writes every metric as a JSON object of counters, gauges and histograms, with durations in microseconds.
+    static void WriteSnapshot(std::ostream& output);
+    static bool WriteSnapshot(const std::string& path);
+
+    // Rewrites the snapshot file on a background thread every interval, until stopped.
+    static void StartPeriodicDump(const std::string& path, float intervalSeconds);
+    static void StopPeriodicDump();
+};
@@ -0,0 +1,129 @@
+#include <fstream>
+#include "logging\Logger.h"
+#include "Tracer.h"
+
+// One thread's ring of events. Only the owning thread writes; exports read concurrently.
+struct Tracer::ThreadBuffer
+{
+    struct Event
+    {
+        std::atomic<const char*> name;
+        std::atomic<long long> startNanoseconds;
+        std::atomic<long long> durationNanoseconds;
+    };
+
+    unsigned int threadId;
+
+    // Guarded by the threads lock, as it's only set and read rarely.
+    std::string threadName;
+
+    // Count of events ever written. Event i is stored at i % eventsPerThread.
+    std::atomic<unsigned long long> writtenEvents;
+    Event events[eventsPerThread];
+
+    ThreadBuffer(unsigned int threadId)
+        : threadId(threadId), threadName(), writtenEvents(0)
+    {
+    }
+};
+
+std::mutex Tracer::threadsLock;
+std::vector<std::shared_ptr<Tracer::ThreadBuffer>> Tracer::threads;
+const std::chrono::steady_clock::time_point Tracer::epoch = std::chrono::steady_clock::now();
+
+// Buffers are kept by the tracer after their thread exits, so short-lived threads still show in exports.
+static thread_local Tracer::ThreadBuffer* threadBuffer = nullptr;
+
+Tracer::ThreadBuffer* Tracer::CreateThreadBuffer()
+{
+    std::lock_guard<std::mutex> lock(threadsLock);
+    threads.push_back(std::make_shared<ThreadBuffer>((unsigned int)threads.size() + 1));
+    return threads.back().get();
+}
+
+void Tracer::Record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    if (threadBuffer == nullptr)
+    {
+        threadBuffer = CreateThreadBuffer();
+    }
+
+    unsigned long long index = threadBuffer->writtenEvents.load(std::memory_order_relaxed);
+    ThreadBuffer::Event& event = threadBuffer->events[index % eventsPerThread];
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count(), std::memory_order_relaxed);
+    event.durationNanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), std::memory_order_relaxed);
+
+    // Publishes the event; exports only read events below this count.
+    threadBuffer->writtenEvents.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::SetThreadName(const std::string& name)
+{
+    if (threadBuffer == nullptr)
+    {
+        threadBuffer = CreateThreadBuffer();
+    }
+
+    std::lock_guard<std::mutex> lock(threadsLock);
+    threadBuffer->threadName = name;
+}
+
+bool Tracer::WriteChromeTrace(const std::string& path)
+{
+    std::ofstream trace(path, std::ios::trunc);
+    if (!trace)
+    {
+        Logger::LogError("Unable to write the trace to '", path, "'.");
+        return false;
+    }
+
+    struct CopiedEvent
+    {
+        const char* name;
+        long long startNanoseconds;
+        long long durationNanoseconds;
+    };
+
+    std::lock_guard<std::mutex> lock(threadsLock);
+    trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    const char* separator = "\n";
+    std::size_t eventCount = 0;
+    std::vector<CopiedEvent> copiedEvents;
+    for (const std::shared_ptr<ThreadBuffer>& thread : threads)
+    {
+        std::string threadName = thread->threadName.empty() ? "Thread " + std::to_string(thread->threadId) : thread->threadName;
+        trace << separator << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread->threadId
+              << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+        separator = ",\n";
+
+        // Copy the ring, then drop whatever the thread may have overwritten while it was being copied.
+        unsigned long long end = thread->writtenEvents.load(std::memory_order_acquire);
+        unsigned long long begin = end > eventsPerThread ? end - eventsPerThread : 0;
+        copiedEvents.clear();
+        for (unsigned long long i = begin; i < end; i++)
+        {
+            const ThreadBuffer::Event& event = thread->events[i % eventsPerThread];
+            copiedEvents.push_back({ event.name.load(std::memory_order_relaxed), event.startNanoseconds.load(std::memory_order_relaxed),
+                event.durationNanoseconds.load(std::memory_order_relaxed) });
+        }
+
+        // The thread may also be partway through writing event endAfterCopy, over the slot of event endAfterCopy - eventsPerThread.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        unsigned long long endAfterCopy = thread->writtenEvents.load(std::memory_order_relaxed);
+        unsigned long long firstIntact = endAfterCopy + 1 > eventsPerThread ? endAfterCopy + 1 - eventsPerThread : 0;
+        for (unsigned long long i = std::max(begin, firstIntact); i < end; i++)
+        {
+            const CopiedEvent& event = copiedEvents[(std::size_t)(i - begin)];
+            trace << ",\n{\"ph\":\"X\",\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << thread->threadId
+                  << ",\"ts\":" << event.startNanoseconds / 1000 << "." << event.startNanoseconds % 1000 / 100
+                  << ",\"dur\":" << event.durationNanoseconds / 1000 << "." << event.durationNanoseconds % 1000 / 100 << "}";
+            ++eventCount;
+        }
+    }
+
+    trace << "\n]}\n";
+    Logger::Log("Wrote ", eventCount, " trace events from ", threads.size(), " threads to '", path, "'.");
+    return true;
+}
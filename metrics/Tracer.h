@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Records timed scopes per thread, for export as a Chrome trace (chrome://tracing, or ui.perfetto.dev).
+// Each thread writes into its own ring of recent events with relaxed atomic stores, so recording never locks or allocates
+//  after a thread's first event, and costs two clock reads per scope. Only the most recent events per thread are kept.
+// Define LUX_DISABLE_TRACING to compile the macros out entirely.
+class Tracer
+{
+public:
+    struct ThreadBuffer;
+
+private:
+    static std::mutex threadsLock;
+    static std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    static const std::chrono::steady_clock::time_point epoch;
+
+    static ThreadBuffer* CreateThreadBuffer();
+
+public:
+    // Events kept per thread. At a few hundred scopes per second per thread, this is over a minute of history.
+    static const unsigned int eventsPerThread = 16384;
+
+    // Names must outlive the tracer, as only the pointer is stored. String literals are ideal.
+    static void Record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    // Names the calling thread in the trace.
+    static void SetThreadName(const std::string& name);
+
+    // Writes every thread's recent events as Chrome trace JSON, returning false if the file can't be written.
+    // Safe to call while threads are recording; events overwritten during the export are left out.
+    static bool WriteChromeTrace(const std::string& path);
+};
+
+// Records the time from construction to destruction as an event.
+class TraceScope
+{
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit TraceScope(const char* name)
+        : name(name), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~TraceScope()
+    {
+        Tracer::Record(name, start, std::chrono::steady_clock::now());
+    }
+};
+
+#define LUX_TRACE_CONCATENATE_INNER(a, b) a##b
+#define LUX_TRACE_CONCATENATE(a, b) LUX_TRACE_CONCATENATE_INNER(a, b)
+
+#ifndef LUX_DISABLE_TRACING
+#define TRACE_SCOPE(name) TraceScope LUX_TRACE_CONCATENATE(traceScope, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Tracer::SetThreadName(name)
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_THREAD_NAME(name)
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+
+// Describes the device state a block of SDR data was acquired with, so downstream stages can detect stale or partial data.
+struct BlockMetadata
+{
+    // Monotonic time at which the block finished being read from the device.
+    std::chrono::steady_clock::time_point captureTime;
+
+    // Sequence number of the block. Matches the SdrBuffer block ID the block was stored under.
+    unsigned int sequence;
+
+    // Incremented by the SdrBuffer whenever the center frequency, gain, or sample rate changes.
+    unsigned int tuningId;
+
+    // Tuning state of the device when the block was read.
+    unsigned int centerFrequency;
+    unsigned int sampleRate;
+    int gainId;
+
+    // True if the device returned a partial block, or the consumer fell far enough behind that blocks were overwritten.
+    bool droppedSamples;
+
+    BlockMetadata()
+        : captureTime(), sequence(0), tuningId(0), centerFrequency(0), sampleRate(0), gainId(-1), droppedSamples(false)
+    {
+    }
+};
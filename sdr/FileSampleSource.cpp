@@ -0,0 +1,96 @@
+#include "logging\Logger.h"
+#include "Sdr.h"
+#include "FileSampleSource.h"
+
+FileSampleSource::FileSampleSource(std::string path, unsigned int centerFrequency, unsigned int sampleRate)
+    : path(path), file(), centerFrequency(centerFrequency), sampleRate(sampleRate), gainId(0)
+{
+}
+
+bool FileSampleSource::Open()
+{
+    file.open(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        Logger::LogError("Unable to open the I/Q recording '", path, "'.");
+        return false;
+    }
+
+    // Each sample is an I/Q pair, so only whole pairs are read. A file without a single block is of no use.
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (length < (std::streamoff)Sdr::BLOCK_SIZE)
+    {
+        Logger::LogError("The I/Q recording '", path, "' is shorter than a single block.");
+        file.close();
+        return false;
+    }
+
+    Logger::Log("Replaying ", length / 2, " samples from '", path, "'.");
+    return true;
+}
+
+bool FileSampleSource::ResetBuffer(int deviceId)
+{
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    return file.good();
+}
+
+bool FileSampleSource::ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead)
+{
+    std::streamsize bytes = (std::streamsize)blocks * Sdr::BLOCK_SIZE;
+    std::streamsize copied = 0;
+    while (copied < bytes)
+    {
+        file.read(reinterpret_cast<char*>(buffer + copied), bytes - copied);
+        copied += file.gcount();
+
+        // Loop back to the start, keeping to whole I/Q pairs so I and Q don't swap places.
+        if (copied < bytes)
+        {
+            copied -= copied % 2;
+            if (!ResetBuffer(deviceId))
+            {
+                break;
+            }
+        }
+    }
+
+    *bytesRead = (int)copied;
+    return copied == bytes;
+}
+
+bool FileSampleSource::SetCenterFrequency(int deviceId, unsigned int frequency)
+{
+    centerFrequency = frequency;
+    return true;
+}
+
+unsigned int FileSampleSource::GetCenterFrequency(int deviceId)
+{
+    return centerFrequency;
+}
+
+bool FileSampleSource::SetSampleRate(int deviceId, unsigned int rate)
+{
+    sampleRate = rate;
+    return true;
+}
+
+unsigned int FileSampleSource::GetSampleRate(int deviceId)
+{
+    return sampleRate;
+}
+
+int FileSampleSource::GetTunerGain(int deviceId)
+{
+    return gainId;
+}
+
+bool FileSampleSource::SetTunerGain(int deviceId, int gainId)
+{
+    this->gainId = gainId;
+    return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include "ISampleSource.h"
+
+// Replays a recording of raw 8-bit I/Q bytes, as written by rtl_sdr, as fast as it's read. Loops at the end of the file.
+// The file doesn't record its tuning, so that is whatever it is configured as.
+class FileSampleSource : public ISampleSource
+{
+    std::string path;
+    std::ifstream file;
+
+    unsigned int centerFrequency;
+    unsigned int sampleRate;
+    int gainId;
+
+public:
+    FileSampleSource(std::string path, unsigned int centerFrequency, unsigned int sampleRate);
+
+    // Opens the recording, returning false if it can't be read.
+    bool Open();
+
+    // Inherited via ISampleSource
+    virtual bool ResetBuffer(int deviceId) override;
+    virtual bool ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead) override;
+    virtual bool SetCenterFrequency(int deviceId, unsigned int frequency) override;
+    virtual unsigned int GetCenterFrequency(int deviceId) override;
+    virtual bool SetSampleRate(int deviceId, unsigned int rate) override;
+    virtual unsigned int GetSampleRate(int deviceId) override;
+    virtual int GetTunerGain(int deviceId) override;
+    virtual bool SetTunerGain(int deviceId, int gainId) override;
+};
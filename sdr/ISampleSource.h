@@ -0,0 +1,27 @@
+#pragma once
+
+// Anything the SdrBuffer can acquire raw 8-bit I/Q bytes from: an RTL-SDR device, a recording, or generated signals.
+// Device IDs are those of the Sdr; sources with a single stream ignore them.
+class ISampleSource
+{
+public:
+    // Discards anything buffered, so the next read starts fresh.
+    virtual bool ResetBuffer(int deviceId) = 0;
+
+    // Reads blocks of Sdr::BLOCK_SIZE bytes, interleaved as [I, Q] [I, Q] ..., each byte offset by 127.5.
+    virtual bool ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead) = 0;
+
+    virtual bool SetCenterFrequency(int deviceId, unsigned int frequency) = 0;
+    virtual unsigned int GetCenterFrequency(int deviceId) = 0;
+
+    virtual bool SetSampleRate(int deviceId, unsigned int rate) = 0;
+    virtual unsigned int GetSampleRate(int deviceId) = 0;
+
+    // Returns the ID of the gain within the device's gain settings, -1 on failure.
+    virtual int GetTunerGain(int deviceId) = 0;
+    virtual bool SetTunerGain(int deviceId, int gainId) = 0;
+
+    virtual ~ISampleSource()
+    {
+    }
+};
@@ -2,6 +2,7 @@
 #include <map>
 #include <vector>
 #include <glm\vec2.hpp>
+#include "ISampleSource.h"
 #include "RtlSdrDllLoader.h"
 
 struct DeviceDetails
@@ -21,7 +22,7 @@ struct DeviceDetails
 };
 
 // Defines an SDR interface abstracting away the device. TODO more abstraction once I have usable algorithms.
-class Sdr
+class Sdr : public ISampleSource
 {
     void* device;
     RtlSdrDllLoader rawLayer;
@@ -44,19 +45,19 @@ public:
     bool OpenDevice(int deviceId);
     
     // Frequency functionality
-    bool SetCenterFrequency(int deviceId, unsigned int frequency);
-    unsigned int GetCenterFrequency(int deviceId);
+    virtual bool SetCenterFrequency(int deviceId, unsigned int frequency) override;
+    virtual unsigned int GetCenterFrequency(int deviceId) override;
     int GetFrequencyCorrection(int deviceId);
     bool SetFrequencyCorrection(int deviceId, int ppm);
 
     // Bandwidth functionality
     bool SetTunerBandwidth(int deviceId, unsigned int bandwidth);
-    unsigned int GetSampleRate(int deviceId);
-    bool SetSampleRate(int deviceId, unsigned int rate);
+    virtual unsigned int GetSampleRate(int deviceId) override;
+    virtual bool SetSampleRate(int deviceId, unsigned int rate) override;
 
     // Gain functionality
-    int GetTunerGain(int deviceId); // Returns the ID of the gain within the vector, -1 on failure.
-    bool SetTunerGain(int deviceId, int gainId); // ID of the gain within the vector.
+    virtual int GetTunerGain(int deviceId) override; // Returns the ID of the gain within the vector, -1 on failure.
+    virtual bool SetTunerGain(int deviceId, int gainId) override; // ID of the gain within the vector.
     std::vector<int> GetTunerGainSettings(int deviceId);
     bool SetTunerGainMode(int deviceId, bool manualMode);
     bool SetInternalAutoGain(int deviceId, bool enable);
@@ -64,8 +65,8 @@ public:
     // Acquisition functionality
     // Useful information on the IQ format: http://whiteboard.ping.se/SDR/IQ
     // Format: [I, Q] [I, Q] ... [In, Qn] Subtract 127 to get the actual value (8-bit accuracy)
-    bool ResetBuffer(int deviceId);
-    bool ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead);
+    virtual bool ResetBuffer(int deviceId) override;
+    virtual bool ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead) override;
 
-    ~Sdr();
+    virtual ~Sdr();
 };
@@ -2,11 +2,18 @@
 #include <atomic>
 #include <future>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <glm\vec2.hpp>
 #include <SFML\System.hpp>
 #include "logging\Logger.h"
+#include "math\IqConverter.h"
+#include "metrics\MetricsRegistry.h"
+#include "metrics\Tracer.h"
+#include "BlockMetadata.h"
+#include "ISampleSource.h"
 #include "Sdr.h"
+#include "AsyncLogger.h"
 
 // Defines a buffer to continually receive data from the SDR device.
 // TODO break this apart correctly from CPP to H when it isn't too late, make it easy for a consumer to retrieve the data in nice blocks, and actually display the data.
@@ -14,7 +21,7 @@ class SdrBuffer
 {
     const unsigned int bufferBlockReadSize = 16;
 
-    Sdr* sdrDevice;
+    ISampleSource* sdrDevice;
     unsigned int deviceId;
 
     std::atomic<bool> isAcquiring;
@@ -26,6 +33,18 @@ class SdrBuffer
     unsigned int bufferBlocks;
     std::vector<unsigned char> rollingBuffer;
 
+    // Metadata for each block in the rolling buffer, indexed the same as the blocks themselves.
+    std::mutex metadataLock;
+    std::vector<BlockMetadata> blockMetadata;
+
+    // The tuning state applied to newly-read blocks. Guarded by the metadata lock.
+    BlockMetadata tuningState;
+
+    // Complex float copy of the rolling buffer, converted once on acquisition so every filter can share it.
+    IqConverter iqConverter;
+    SampleBlock<std::complex<float>> convertedBuffer;
+    unsigned int convertedTuningId;
+
     // Data from start to here is valid, exclusive.
     std::atomic<unsigned int> blockId;
     unsigned int currentBufferPosition;
@@ -34,17 +53,40 @@ class SdrBuffer
     std::atomic<float> elapsedTime;
     std::atomic<unsigned int> acquiredSamples;
     std::atomic<float> dataSampleRate;
+
+    // Reads that failed or came back short, over the life of the buffer.
+    Counter droppedReads;
+    Counter acquiredBlocks;
+
+    // Time spent waiting on each read from the device, and the sample rate it was delivered at.
+    LatencyHistogram readTime;
+    Gauge sampleRateGauge;
 public:
     
     // BlockReadSize is recommended to be 16, blocks should be a multiple of the read size for best performance (ie, 80)
-    SdrBuffer(Sdr* sdrDevice, unsigned int deviceId, unsigned int bufferSize)
+    SdrBuffer(ISampleSource* sdrDevice, unsigned int deviceId, unsigned int bufferSize)
         : sdrDevice(sdrDevice), deviceId(deviceId), isAcquiring(false), isTerminating(false), 
           readBlocks(bufferSize), bufferBlocks(bufferSize * bufferBlockReadSize),
-          rollingBuffer(), currentBufferPosition(0), blockId(0),
-          elapsedTime(0.0f), acquiredSamples(0), dataSampleRate(0.0f)
+          rollingBuffer(), blockMetadata(bufferSize), tuningState(), iqConverter(), convertedBuffer(), convertedTuningId(0),
+          currentBufferPosition(0), blockId(0),
+          elapsedTime(0.0f), acquiredSamples(0), dataSampleRate(0.0f), droppedReads(), acquiredBlocks(), readTime(), sampleRateGauge()
     {
         Logger::Log("Creating a buffer of ", bufferBlocks, " blocks with a reads size of ", bufferBlockReadSize);
         rollingBuffer.reserve(Sdr::BLOCK_SIZE * bufferBlocks);
+        convertedBuffer.Resize(Sdr::BLOCK_SIZE * bufferBlocks / 2);
+
+        MetricsRegistry::Register("sdr.dropped_reads", &droppedReads);
+        MetricsRegistry::Register("sdr.acquired_blocks", &acquiredBlocks);
+        MetricsRegistry::Register("sdr.read_time", &readTime);
+        MetricsRegistry::Register("sdr.sample_rate", &sampleRateGauge);
+    }
+
+    ~SdrBuffer()
+    {
+        MetricsRegistry::Unregister("sdr.dropped_reads", &droppedReads);
+        MetricsRegistry::Unregister("sdr.acquired_blocks", &acquiredBlocks);
+        MetricsRegistry::Unregister("sdr.read_time", &readTime);
+        MetricsRegistry::Unregister("sdr.sample_rate", &sampleRateGauge);
     }
     
     float GetCurrentSampleRate() const
@@ -57,6 +99,11 @@ public:
         return blockId.load();
     }
 
+    unsigned int GetDroppedReads() const
+    {
+        return (unsigned int)droppedReads.Get();
+    }
+
     unsigned int GetReadSize() const
     {
         return Sdr::BLOCK_SIZE * bufferBlockReadSize;
@@ -72,6 +119,108 @@ public:
         return rollingBuffer;
     }
 
+    // Returns the complex samples of the provided block ID, without copying them.
+    // The samples are only valid until the acquisition thread wraps around the rolling buffer and overwrites them.
+    SampleView<const std::complex<float>> GetBlockSamples(unsigned int id) const
+    {
+        unsigned int samplesPerBlock = GetReadSize() / 2;
+        return convertedBuffer.Subview((id % readBlocks) * samplesPerBlock, samplesPerBlock);
+    }
+
+    // Returns the raw I/Q bytes of the provided block ID, for consumers that do their own (e.g. fixed-point) conversion.
+    // As with GetBlockSamples, these are only valid until the acquisition thread overwrites them.
+    SampleView<const IqByte> GetBlockRawSamples(unsigned int id) const
+    {
+        return SampleView<const IqByte>(reinterpret_cast<const IqByte*>(rollingBuffer.data() + (id % readBlocks) * GetReadSize()), GetReadSize() / 2);
+    }
+
+    // Returns a copy of the metadata stored for the provided block ID.
+    // If the block has since been overwritten, the returned sequence will not match the block ID.
+    BlockMetadata GetBlockMetadata(unsigned int id)
+    {
+        std::lock_guard<std::mutex> lock(metadataLock);
+        return blockMetadata[id % readBlocks];
+    }
+
+    // Tuning functionality. These should be used instead of the Sdr equivalents while acquiring, so blocks are tagged correctly.
+    bool SetCenterFrequency(unsigned int frequency)
+    {
+        std::lock_guard<std::mutex> lock(metadataLock);
+        if (!sdrDevice->SetCenterFrequency(deviceId, frequency))
+        {
+            return false;
+        }
+
+        tuningState.centerFrequency = frequency;
+        ++tuningState.tuningId;
+        return true;
+    }
+
+    bool SetSampleRate(unsigned int rate)
+    {
+        std::lock_guard<std::mutex> lock(metadataLock);
+        if (!sdrDevice->SetSampleRate(deviceId, rate))
+        {
+            return false;
+        }
+
+        tuningState.sampleRate = rate;
+        ++tuningState.tuningId;
+        return true;
+    }
+
+    bool SetTunerGain(int gainId)
+    {
+        std::lock_guard<std::mutex> lock(metadataLock);
+        if (!sdrDevice->SetTunerGain(deviceId, gainId))
+        {
+            return false;
+        }
+
+        tuningState.gainId = gainId;
+        ++tuningState.tuningId;
+        return true;
+    }
+
+    // Reloads the tuning state from the device, for when it was configured directly through the Sdr.
+    void RefreshTuningState()
+    {
+        std::lock_guard<std::mutex> lock(metadataLock);
+        tuningState.centerFrequency = sdrDevice->GetCenterFrequency(deviceId);
+        tuningState.sampleRate = sdrDevice->GetSampleRate(deviceId);
+        tuningState.gainId = sdrDevice->GetTunerGain(deviceId);
+        ++tuningState.tuningId;
+    }
+
+    // Converts the block about to be completed into complex samples, restarting DC offset tracking after retunes.
+    void ConvertBlock()
+    {
+        metadataLock.lock();
+        unsigned int tuningId = tuningState.tuningId;
+        metadataLock.unlock();
+
+        if (tuningId != convertedTuningId)
+        {
+            iqConverter.ResetDcOffset();
+            convertedTuningId = tuningId;
+        }
+
+        unsigned int samplesPerBlock = GetReadSize() / 2;
+        SampleView<const IqByte> rawSamples(reinterpret_cast<const IqByte*>(&rollingBuffer[currentBufferPosition]), samplesPerBlock);
+        iqConverter.Convert(rawSamples, convertedBuffer.Subview((blockId.load() % readBlocks) * samplesPerBlock, samplesPerBlock));
+    }
+
+    // Tags the block about to be completed with the current tuning state.
+    void StoreBlockMetadata(bool droppedSamples)
+    {
+        std::lock_guard<std::mutex> lock(metadataLock);
+        BlockMetadata& metadata = blockMetadata[blockId.load() % readBlocks];
+        metadata = tuningState;
+        metadata.captureTime = std::chrono::steady_clock::now();
+        metadata.sequence = blockId.load();
+        metadata.droppedSamples = droppedSamples;
+    }
+
     void AdvanceBufferPositions()
     {
         ++blockId;
@@ -97,6 +246,7 @@ public:
         }
 
         isAcquiring = true;
+        RefreshTuningState();
 
         Logger::Log("Starting data acquisition: ", isAcquiring.load(), " ", isTerminating.load());
         dataAcquisitionThread = std::async(std::launch::async, &SdrBuffer::AcquireData, this);
@@ -104,24 +254,41 @@ public:
 
     void AcquireData()
     {
-        Logger::Log("Resetting RTL-SDR buffer to read data: ", sdrDevice->ResetBuffer(0));
+        TRACE_THREAD_NAME("SDR acquisition");
+        Logger::Log("Resetting the sample source buffer to read data: ", sdrDevice->ResetBuffer(deviceId));
 
         while (isAcquiring)
         {
+            TRACE_SCOPE("SdrBuffer::AcquireData");
             sf::Clock clock;
 
             int bytesRead = 0;
-            if (!sdrDevice->ReadBlock(deviceId, &rollingBuffer[currentBufferPosition], bufferBlockReadSize, &bytesRead))
+            bool droppedSamples = false;
+            std::chrono::steady_clock::time_point readStart = std::chrono::steady_clock::now();
+            bool readSucceeded = sdrDevice->ReadBlock(deviceId, &rollingBuffer[currentBufferPosition], bufferBlockReadSize, &bytesRead);
+            std::chrono::steady_clock::time_point readEnd = std::chrono::steady_clock::now();
+            readTime.Record(readEnd - readStart);
+            Tracer::Record("SdrBuffer::ReadBlock", readStart, readEnd);
+            if (!readSucceeded)
             {
-                Logger::Log("Error reading from the SDR device: ", deviceId);
+                ASYNC_LOG_ERROR("Error reading from the SDR device: ", deviceId);
+                droppedSamples = true;
             }
             else if (bytesRead != this->GetReadSize())
             {
-                Logger::LogWarn("Unable to read a full block from the SDR device. Read ", bytesRead, " bytes instead.");
-                Logger::LogWarn("Block ID ", blockId.load(), " will be corrupted.");
+                ASYNC_LOG_WARN("Unable to read a full block from the SDR device. Read ", bytesRead, " bytes instead; block ID ", blockId.load(), " will be corrupted.");
+                droppedSamples = true;
             }
 
+            if (droppedSamples)
+            {
+                droppedReads.Increment();
+            }
+
+            ConvertBlock();
+            StoreBlockMetadata(droppedSamples);
             AdvanceBufferPositions();
+            acquiredBlocks.Increment();
 
             // Compute how fast we're acquiring samples, averaged over a second.
             acquiredSamples = acquiredSamples + bytesRead;
@@ -129,6 +296,7 @@ public:
             if (elapsedTime > 1.0f)
             {
                 dataSampleRate = acquiredSamples / elapsedTime;
+                sampleRateGauge.Set(dataSampleRate / 2.0f);
                 acquiredSamples = 0;
                 elapsedTime = 0;
             }
@@ -149,4 +317,13 @@ public:
         isAcquiring = false;
         Logger::Log("Stopping data acquisition: ", isAcquiring.load(), " ", isTerminating.load());
     }
+
+    // Blocks until the acquisition thread has finished, so the device can be safely used elsewhere.
+    void WaitForAcquisitionStop()
+    {
+        if (dataAcquisitionThread.valid())
+        {
+            dataAcquisitionThread.wait();
+        }
+    }
 };
@@ -0,0 +1,226 @@
+#include <chrono>
+#include <cmath>
+#include "logging\Logger.h"
+#include "math\FourierTransform.h"
+#include "AsyncLogger.h"
+#include "SweepScanner.h"
+
+SweepScanner::SweepScanner(Sdr* sdrDevice, unsigned int deviceId)
+    : sdrDevice(sdrDevice), deviceId(deviceId), startFrequency(0), stopFrequency(0), sampleRate(0), fftSize(0),
+      settleBlocks(0), dwellBlocks(0), hopCount(0), binsPerHop(0), isSweeping(false),
+      widebandSpectrum(), completedSweeps(0), sweepRate(0.0f)
+{
+}
+
+bool SweepScanner::Configure(unsigned int startFrequency, unsigned int stopFrequency, unsigned int fftSize, unsigned int settleBlocks, unsigned int dwellBlocks)
+{
+    if (isSweeping)
+    {
+        Logger::LogWarn("Cannot reconfigure the sweep scanner while it is sweeping.");
+        return false;
+    }
+
+    bool inValidRange = false;
+    for (const glm::ivec2& range : Sdr::ValidFrequencyRanges)
+    {
+        if (startFrequency >= (unsigned int)range.x && stopFrequency <= (unsigned int)range.y)
+        {
+            inValidRange = true;
+        }
+    }
+
+    if (!inValidRange || startFrequency >= stopFrequency)
+    {
+        Logger::LogWarn("Cannot sweep from ", startFrequency, " Hz to ", stopFrequency, " Hz, as it is outside of the valid frequency ranges.");
+        return false;
+    }
+
+    if (fftSize == 0 || (fftSize & (fftSize - 1)) != 0 || dwellBlocks == 0 || (dwellBlocks * Sdr::BLOCK_SIZE / 2) < fftSize)
+    {
+        Logger::LogWarn("The sweep FFT size must be a power of 2 no larger than a dwell: ", fftSize, ", ", dwellBlocks, " dwell blocks.");
+        return false;
+    }
+
+    this->startFrequency = startFrequency;
+    this->stopFrequency = stopFrequency;
+    this->fftSize = fftSize;
+    this->settleBlocks = settleBlocks;
+    this->dwellBlocks = dwellBlocks;
+
+    sampleRate = sdrDevice->GetSampleRate(deviceId);
+    binsPerHop = (unsigned int)((float)fftSize * usableBandwidthFraction) & ~1u;
+    unsigned int hopBandwidth = (unsigned int)((unsigned long long)binsPerHop * sampleRate / fftSize);
+    hopCount = (stopFrequency - startFrequency + hopBandwidth - 1) / hopBandwidth;
+
+    dwellBuffers[0].Resize(dwellBlocks * Sdr::BLOCK_SIZE / 2);
+    dwellBuffers[1].Resize(dwellBlocks * Sdr::BLOCK_SIZE / 2);
+    settleBuffer.resize(std::max(settleBlocks, 1u) * Sdr::BLOCK_SIZE);
+
+    spectrumLock.lock();
+    widebandSpectrum.assign(hopCount * binsPerHop, 0.0f);
+    spectrumLock.unlock();
+
+    Logger::Log("Configured a sweep of ", hopCount, " hops of ", hopBandwidth, " Hz from ", startFrequency, " Hz to ", stopFrequency, " Hz.");
+    return true;
+}
+
+unsigned int SweepScanner::GetHopFrequency(unsigned int hop) const
+{
+    unsigned int hopBandwidth = (unsigned int)((unsigned long long)binsPerHop * sampleRate / fftSize);
+    unsigned int frequency = startFrequency + hopBandwidth * hop + hopBandwidth / 2;
+    return std::min(frequency, (unsigned int)Sdr::ValidFrequencyRanges.back().y);
+}
+
+void SweepScanner::StartSweep()
+{
+    if (isSweeping || hopCount == 0)
+    {
+        return;
+    }
+
+    isSweeping = true;
+    Logger::Log("Starting frequency sweep.");
+    sweepThread = std::async(std::launch::async, &SweepScanner::Sweep, this);
+}
+
+void SweepScanner::StopSweep()
+{
+    if (!isSweeping)
+    {
+        return;
+    }
+
+    isSweeping = false;
+    sweepThread.wait();
+    Logger::Log("Stopped frequency sweep.");
+}
+
+void SweepScanner::Sweep()
+{
+    Logger::Log("Resetting RTL-SDR buffer to sweep: ", sdrDevice->ResetBuffer(deviceId));
+    if (!sdrDevice->SetCenterFrequency(deviceId, GetHopFrequency(0)))
+    {
+        Logger::LogError("Unable to tune to the first sweep frequency of ", GetHopFrequency(0), " Hz.");
+    }
+
+    std::future<void> processing;
+    int currentBuffer = 0;
+    while (isSweeping)
+    {
+        auto sweepStartTime = std::chrono::steady_clock::now();
+
+        unsigned int hop = 0;
+        for (; hop < hopCount && isSweeping; hop++)
+        {
+            // Discard the samples captured while the PLL settles after the last retune.
+            int bytesRead = 0;
+            if (settleBlocks != 0)
+            {
+                sdrDevice->ReadBlock(deviceId, &settleBuffer[0], settleBlocks, &bytesRead);
+            }
+
+            unsigned char* dwell = reinterpret_cast<unsigned char*>(dwellBuffers[currentBuffer].data());
+            if (!sdrDevice->ReadBlock(deviceId, dwell, dwellBlocks, &bytesRead) || bytesRead != dwellBlocks * Sdr::BLOCK_SIZE)
+            {
+                ASYNC_LOG_WARN("Unable to read a full dwell at ", GetHopFrequency(hop), " Hz. Read ", bytesRead, " bytes.");
+            }
+
+            // Retune immediately so the PLL settles while this dwell is processed.
+            unsigned int nextHop = (hop + 1) % hopCount;
+            if (!sdrDevice->SetCenterFrequency(deviceId, GetHopFrequency(nextHop)))
+            {
+                ASYNC_LOG_WARN("Unable to tune to the sweep frequency of ", GetHopFrequency(nextHop), " Hz.");
+            }
+
+            // Only one dwell is in flight at a time, as the buffer it uses is about to be refilled.
+            if (processing.valid())
+            {
+                processing.wait();
+            }
+
+            processing = std::async(std::launch::async, &SweepScanner::ProcessDwell, this, dwellBuffers[currentBuffer].View(), hop);
+            currentBuffer = 1 - currentBuffer;
+        }
+
+        if (processing.valid())
+        {
+            processing.wait();
+        }
+
+        if (hop == hopCount)
+        {
+            std::chrono::duration<float> sweepTime = std::chrono::steady_clock::now() - sweepStartTime;
+            sweepRate = ((float)(stopFrequency - startFrequency) / 1e6f) / sweepTime.count();
+            ++completedSweeps;
+            Logger::Log("Swept ", (stopFrequency - startFrequency) / 1000000, " MHz in ", sweepTime.count(), " sec (", sweepRate.load(), " MHz/s).");
+        }
+    }
+}
+
+void SweepScanner::ProcessDwell(SampleView<const IqByte> dwell, unsigned int hop)
+{
+    std::vector<float> power(fftSize, 0.0f);
+    std::vector<float> reals;
+    std::vector<float> imags;
+
+    unsigned int frames = (unsigned int)dwell.size() / fftSize;
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        FourierTransform::ComplexFFT(dwell.Subview(i * fftSize, fftSize), reals, imags);
+        for (unsigned int j = 0; j < fftSize; j++)
+        {
+            power[j] += reals[j] * reals[j] + imags[j] * imags[j];
+        }
+    }
+
+    // The DC bin holds the tuner's LO leakage, so interpolate across it.
+    power[0] = (power[1] + power[fftSize - 1]) / 2.0f;
+
+    // Bins are stored with DC first. Keep the center of the band, with the lowest frequency first.
+    unsigned int skippedBins = (fftSize - binsPerHop) / 2;
+    spectrumLock.lock();
+    for (unsigned int i = 0; i < binsPerHop; i++)
+    {
+        unsigned int bin = (i + skippedBins + fftSize / 2) % fftSize;
+        widebandSpectrum[hop * binsPerHop + i] = 10.0f * std::log10(power[bin] / (float)frames + 1e-12f);
+    }
+
+    spectrumLock.unlock();
+}
+
+bool SweepScanner::IsSweeping() const
+{
+    return isSweeping;
+}
+
+float SweepScanner::GetSweepRate() const
+{
+    return sweepRate;
+}
+
+unsigned int SweepScanner::GetCompletedSweeps() const
+{
+    return completedSweeps;
+}
+
+unsigned int SweepScanner::GetStartFrequency() const
+{
+    return startFrequency;
+}
+
+unsigned int SweepScanner::GetStopFrequency() const
+{
+    return stopFrequency;
+}
+
+void SweepScanner::GetSpectrum(std::vector<float>& spectrum)
+{
+    spectrumLock.lock();
+    spectrum = widebandSpectrum;
+    spectrumLock.unlock();
+}
+
+SweepScanner::~SweepScanner()
+{
+    StopSweep();
+}
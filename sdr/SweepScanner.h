@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+#include "math\SampleBlock.h"
+#include "Sdr.h"
+
+// Sweeps the SDR device across a frequency range, stitching the power spectrum of each dwell into one wideband spectrum.
+// The device is retuned to the next hop as soon as a dwell is read, so retuning and settling overlap processing of the prior dwell.
+// The SdrBuffer for the same device must not be acquiring while a sweep is running.
+class SweepScanner
+{
+    // Fraction of each dwell's bandwidth that is kept. The band edges are attenuated by the tuner's anti-aliasing filter.
+    const float usableBandwidthFraction = 0.75f;
+
+    Sdr* sdrDevice;
+    unsigned int deviceId;
+
+    unsigned int startFrequency;
+    unsigned int stopFrequency;
+    unsigned int sampleRate;
+    unsigned int fftSize;
+
+    // Blocks (in Sdr::BLOCK_SIZE units) discarded after each retune while the PLL settles, and read per dwell.
+    unsigned int settleBlocks;
+    unsigned int dwellBlocks;
+
+    unsigned int hopCount;
+    unsigned int binsPerHop;
+
+    std::atomic<bool> isSweeping;
+    std::future<void> sweepThread;
+
+    // Double-buffered so one dwell can be processed while the next is read.
+    SampleBlock<IqByte> dwellBuffers[2];
+    std::vector<unsigned char> settleBuffer;
+
+    // Stitched power spectrum, in dB, covering the full range from the start to the stop frequency.
+    std::mutex spectrumLock;
+    std::vector<float> widebandSpectrum;
+    std::atomic<unsigned int> completedSweeps;
+
+    // Sweep rate in MHz/s, averaged over the last complete sweep.
+    std::atomic<float> sweepRate;
+
+    unsigned int GetHopFrequency(unsigned int hop) const;
+    void Sweep();
+
+    // Computes the averaged power spectrum of a dwell, storing the usable bins into the wideband spectrum.
+    void ProcessDwell(SampleView<const IqByte> dwell, unsigned int hop);
+
+public:
+    SweepScanner(Sdr* sdrDevice, unsigned int deviceId);
+
+    // Configures the sweep. Must be called while the scanner is stopped.
+    bool Configure(unsigned int startFrequency, unsigned int stopFrequency, unsigned int fftSize, unsigned int settleBlocks, unsigned int dwellBlocks);
+
+    void StartSweep();
+    void StopSweep();
+    bool IsSweeping() const;
+
+    float GetSweepRate() const;
+    unsigned int GetCompletedSweeps() const;
+    unsigned int GetStartFrequency() const;
+    unsigned int GetStopFrequency() const;
+
+    // Copies the most recent wideband spectrum, in dB.
+    void GetSpectrum(std::vector<float>& spectrum);
+
+    ~SweepScanner();
+};
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "math\Constants.h"
+#include "Sdr.h"
+#include "SyntheticSampleSource.h"
+
+SyntheticSampleSource::SyntheticSampleSource(unsigned int centerFrequency, unsigned int sampleRate)
+    : signal(), readPosition(0), centerFrequency(centerFrequency), sampleRate(sampleRate), gainId(0)
+{
+    // Carriers as fractions of the sample rate, with their amplitudes. Each completes a whole number of cycles over
+    //  the signal, so the replay has no discontinuity where it wraps.
+    const float carriers[][2] = { { 0.0625f, 0.30f }, { -0.203125f, 0.10f }, { 0.3515625f, 0.02f } };
+
+    std::mt19937 generator(1);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+
+    signal.resize((std::size_t)signalSamples * 2);
+    for (unsigned int n = 0; n < signalSamples; n++)
+    {
+        float i = noise(generator);
+        float q = noise(generator);
+        for (const float* carrier : carriers)
+        {
+            // Only the fraction of a cycle matters, and keeping to it keeps the phase accurate late in the signal.
+            double cycles = (double)carrier[0] * (double)n;
+            float phase = 2.0f * Constants::PI * (float)(cycles - std::floor(cycles));
+            i += carrier[1] * std::cos(phase);
+            q += carrier[1] * std::sin(phase);
+        }
+
+        signal[n * 2] = (unsigned char)std::min(std::max(i * 127.5f + 127.5f, 0.0f), 255.0f);
+        signal[n * 2 + 1] = (unsigned char)std::min(std::max(q * 127.5f + 127.5f, 0.0f), 255.0f);
+    }
+}
+
+bool SyntheticSampleSource::ResetBuffer(int deviceId)
+{
+    readPosition = 0;
+    return true;
+}
+
+bool SyntheticSampleSource::ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead)
+{
+    std::size_t bytes = (std::size_t)blocks * Sdr::BLOCK_SIZE;
+    for (std::size_t copied = 0; copied < bytes; )
+    {
+        std::size_t chunk = std::min(bytes - copied, signal.size() - readPosition);
+        std::memcpy(buffer + copied, signal.data() + readPosition, chunk);
+
+        copied += chunk;
+        readPosition = (readPosition + chunk) % signal.size();
+    }
+
+    *bytesRead = (int)bytes;
+    return true;
+}
+
+bool SyntheticSampleSource::SetCenterFrequency(int deviceId, unsigned int frequency)
+{
+    centerFrequency = frequency;
+    return true;
+}
+
+unsigned int SyntheticSampleSource::GetCenterFrequency(int deviceId)
+{
+    return centerFrequency;
+}
+
+bool SyntheticSampleSource::SetSampleRate(int deviceId, unsigned int rate)
+{
+    sampleRate = rate;
+    return true;
+}
+
+unsigned int SyntheticSampleSource::GetSampleRate(int deviceId)
+{
+    return sampleRate;
+}
+
+int SyntheticSampleSource::GetTunerGain(int deviceId)
+{
+    return gainId;
+}
+
+bool SyntheticSampleSource::SetTunerGain(int deviceId, int gainId)
+{
+    this->gainId = gainId;
+    return true;
+}
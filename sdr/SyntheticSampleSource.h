@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include "ISampleSource.h"
+
+// Generates a few carriers in noise, as the RTL-SDR would deliver them, as fast as they're read.
+// The signal is precomputed once and then replayed, so reads cost no more than a copy and never limit throughput.
+class SyntheticSampleSource : public ISampleSource
+{
+    // Long enough that the replay isn't a short repeating pattern to the filters.
+    const unsigned int signalSamples = 1 << 20;
+
+    std::vector<unsigned char> signal;
+    std::size_t readPosition;
+
+    unsigned int centerFrequency;
+    unsigned int sampleRate;
+    int gainId;
+
+public:
+    SyntheticSampleSource(unsigned int centerFrequency, unsigned int sampleRate);
+
+    // Inherited via ISampleSource
+    virtual bool ResetBuffer(int deviceId) override;
+    virtual bool ReadBlock(int deviceId, unsigned char* buffer, unsigned int blocks, int* bytesRead) override;
+    virtual bool SetCenterFrequency(int deviceId, unsigned int frequency) override;
+    virtual unsigned int GetCenterFrequency(int deviceId) override;
+    virtual bool SetSampleRate(int deviceId, unsigned int rate) override;
+    virtual unsigned int GetSampleRate(int deviceId) override;
+    virtual int GetTunerGain(int deviceId) override;
+    virtual bool SetTunerGain(int deviceId, int gainId) override;
+};
@@ -0,0 +1,22 @@
+#version 400 core
+
+in vec2 fs_uv;
+out vec4 color;
+
+// Density of each cell of the plot, one byte per cell.
+uniform sampler2D densityTexture;
+
+// Black, blue, cyan, yellow, red, then white, from the lowest to the highest density. Matches the waterfall.
+vec3 Colormap(float level)
+{
+    const vec3 stops[6] = vec3[6](vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 1.0f),
+                                  vec3(1.0f, 1.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 1.0f, 1.0f));
+    float position = clamp(level, 0.0f, 1.0f) * 5.0f;
+    int index = min(int(position), 4);
+    return mix(stops[index], stops[index + 1], position - float(index));
+}
+
+void main(void)
+{
+    color = vec4(Colormap(texture(densityTexture, fs_uv).r), 1.0f);
+}
@@ -0,0 +1,15 @@
+#version 400 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 uv;
+
+out vec2 fs_uv;
+
+uniform mat4 projMatrix;
+
+// Places the density quad, passing its corners' UVs through to sample the density texture.
+void main(void)
+{
+    fs_uv = uv;
+    gl_Position = projMatrix * vec4(position, 1.0f);
+}
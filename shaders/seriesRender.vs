@@ -0,0 +1,28 @@
+#version 400 core
+
+// A 2D position, or a y value alone (read into x, leaving y 0) when x is implicit.
+layout (location = 0) in vec2 position;
+
+out vec4 fs_color;
+
+uniform float pointSize;
+uniform mat4 projMatrix;
+uniform vec3 seriesColor;
+
+// x origin, x step and the index of the first vertex. A step of 0 means positions are full 2D.
+uniform vec3 implicitX;
+
+// Renders a series of points or lines in a single color from compact vertices.
+void main(void)
+{
+    vec2 xy = position;
+    if (implicitX.y != 0.0f)
+    {
+        xy = vec2(implicitX.x + (float(gl_VertexID) - implicitX.z) * implicitX.y, position.x);
+    }
+
+    fs_color = vec4(seriesColor, 1.0f);
+
+    gl_PointSize = pointSize;
+    gl_Position = projMatrix * vec4(xy, 0.0f, 1.0f);
+}
@@ -0,0 +1,31 @@
+#version 400 core
+
+in vec2 fs_uv;
+out vec4 color;
+
+// Ring of spectrum rows, one byte per bin. The newest row is at the top of the pane, going back in time downwards.
+uniform sampler2D historyTexture;
+
+// Texture V of the newest row's center, and the V span from there to the oldest row's center.
+uniform vec2 rowMapping;
+
+// Visible horizontal range of the spectrum, as fractions of the full range.
+uniform vec2 visibleRange;
+
+// Black, blue, cyan, yellow, red, then white, from the lowest to the highest level.
+vec3 Colormap(float level)
+{
+    const vec3 stops[6] = vec3[6](vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 1.0f),
+                                  vec3(1.0f, 1.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 1.0f, 1.0f));
+    float position = clamp(level, 0.0f, 1.0f) * 5.0f;
+    int index = min(int(position), 4);
+    return mix(stops[index], stops[index + 1], position - float(index));
+}
+
+void main(void)
+{
+    // Rows wrap around the texture, which repeats vertically.
+    float u = mix(visibleRange.x, visibleRange.y, fs_uv.x);
+    float v = rowMapping.x - (1.0f - fs_uv.y) * rowMapping.y;
+    color = vec4(Colormap(texture(historyTexture, vec2(u, v)).r), 1.0f);
+}